@@ -16,6 +16,21 @@
 #include "generic.hpp"
 #include <psi/build/attributes.hpp>
 #include "../dispatch_tracking.hpp"
+#if PSI_SWEATER_TOPOLOGY
+#include "../threading/topology.hpp"
+#endif // PSI_SWEATER_TOPOLOGY
+#include "../threading/wait_helper.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <span>
 //------------------------------------------------------------------------------
 #if PSI_SWEATER_EXACT_WORKER_SELECTION && defined( _WIN32 ) && !defined( _WIN64 )
 struct _IMAGE_DOS_HEADER;
@@ -65,31 +80,142 @@ namespace events
 
     WEAK void worker_thread_init       ( hardware_concurrency_t /*worker_index*/                                                           ) noexcept {}
 
+    WEAK void worker_blocking_begin    ( hardware_concurrency_t /*worker_index*/, bool /*compensated*/                                     ) noexcept {}
+    WEAK void worker_blocking_end      ( hardware_concurrency_t /*worker_index*/                                                           ) noexcept {}
+
 #undef WEAK
 } // namespace events
 
-#if PSI_SWEATER_HMP
-bool shop::hmp = true;
-shop::hmp_config shop::hmp_clusters;
-#endif
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+namespace
+{
+    // The worker slot the current thread serves (as the slot's own worker or
+    // as a compensating spare) - what lets blocking_region find its slot
+    // without scanning the pool (and lets spares hand off in turn).
+    struct serving_slot
+    {
+        shop const           * p_shop;
+        hardware_concurrency_t slot  ;
+    }; // struct serving_slot
+    thread_local serving_slot current_slot{ nullptr, 0 };
+} // anonymous namespace
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
+
+namespace
+{
+    // <prefix><index> - the prefix cut short as needed for the whole index
+    // to fit into the 15 characters of a Linux thread name.
+    [[ maybe_unused ]] // (without exact worker selection workers have no index)
+    void name_active_thread( std::string const & prefix, unsigned const index ) noexcept
+    {
+        if ( prefix.empty() )
+            return;
+        char name[ 16 ];
+        auto const index_length{ std::snprintf( nullptr, 0, "%u", index ) };
+        std::snprintf( name, sizeof( name ), "%.*s%u", static_cast<int>( sizeof( name ) - 1 ) - index_length, prefix.c_str(), index );
+        (void)thrd_lite::thread::set_active_thread_name( name );
+    }
+
+    // Worker item completions retired per counter RMW (see worker_loop()).
+    constexpr hardware_concurrency_t completion_batch{ 16 };
 
 #if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
-#ifdef __ANDROID__
-// The historical Android value, tuned against that platform's slow thread
-// signals -- deliberately untouched by the general-default change below
-// (no Android hardware in the bench fleet to re-tune it on).
-std::uint32_t shop::worker_spin_count{ 100 * 1000 };
-#else
-// Small on purpose -- see generic_config.hpp's spin-before-suspension note:
-// ~1k nops captures the catch-the-next-dispatch win (fire flat-to-better,
-// back-to-back small-spread join ~30-40% faster on Apple Silicon) while
-// large counts regress both by oversubscribing the cores after a join.
-std::uint32_t shop::worker_spin_count{ 1000 };
-#endif // Android
-#if PSI_SWEATER_USE_CALLER_THREAD
-std::uint32_t shop::caller_spin_count{ 100 * 1000 };
-#endif // PSI_SWEATER_USE_CALLER_THREAD
+    // The duration (in picoseconds) of an iteration of the semaphore and
+    // barrier spin loops (nops( 8 ) and a load) - measured once, to turn spin
+    // counts into spin windows.
+    std::uint32_t spin_iteration_picoseconds() noexcept
+    {
+        static auto const picoseconds
+        {
+            []() noexcept
+            {
+                auto constexpr iterations{ 4096 };
+                std::atomic<std::uint32_t> spun_on{ 0 };
+                auto const start{ std::chrono::steady_clock::now() };
+                for ( auto iteration{ 0 }; iteration < iterations; ++iteration )
+                {
+                    thrd_lite::nops( 8 );
+                    (void)spun_on.load( std::memory_order_acquire );
+                }
+                auto const elapsed{ std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count() };
+                return static_cast<std::uint32_t>( std::max<std::int64_t>( 1, elapsed * 1000 / iterations ) );
+            }()
+        };
+        return picoseconds;
+    }
+
+    std::int64_t nanoseconds_since( std::chrono::steady_clock::time_point const start ) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count();
+    }
 #endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+} // anonymous namespace
+
+#if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+// Spin if work arrived within the window in at least half of the recent idle
+// periods. Every 16th period spins regardless: parked periods measure the
+// gap inflated by the wake-up latency, which could otherwise lock a worker
+// into parking after a burst of long gaps.
+bool shop::idle_gap_history::spin() noexcept
+{
+    auto const periods{ periods_.load( std::memory_order_relaxed ) };
+    periods_.store( static_cast<std::uint8_t>( periods + 1 ), std::memory_order_relaxed );
+    return ( std::popcount( arrivals_.load( std::memory_order_relaxed ) ) >= 8 ) || ( periods % 16 == 0 );
+}
+
+void shop::idle_gap_history::record( std::int64_t const gap_nanoseconds, std::uint32_t const spin_count ) noexcept
+{
+    auto const window_nanoseconds{ std::int64_t{ spin_count } * spin_iteration_picoseconds() / 1000 };
+    auto const arrived_within    { gap_nanoseconds <= window_nanoseconds };
+    arrivals_.store( static_cast<std::uint16_t>( ( arrivals_.load( std::memory_order_relaxed ) << 1 ) | arrived_within ), std::memory_order_relaxed );
+}
+#endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+
+#if PSI_SWEATER_TOPOLOGY
+namespace
+{
+    bool has_smt() noexcept
+    {
+        auto const cpus{ thrd_lite::cpu_topology() };
+        return std::any_of( cpus.begin(), cpus.end(), []( thrd_lite::cpu_info const & cpu ) noexcept { return cpu.smt_index != 0; } );
+    }
+
+    // The CPUs the workers are laid out over: cpu_topology() restricted to
+    // the process's allowed CPUs (unless unknown, i.e. empty) and, for
+    // one-per-core placement, to the cores' primary hardware threads.
+    std::vector<thrd_lite::cpu_info> placement_cpus( std::span<thrd_lite::cpu_id_t const> const allowed, bool const primary_threads_only )
+    {
+        std::vector<thrd_lite::cpu_info> cpus;
+        for ( auto const & cpu : thrd_lite::cpu_topology() )
+        {
+            if ( primary_threads_only && cpu.smt_index )
+                continue;
+            if ( allowed.empty() || std::binary_search( allowed.begin(), allowed.end(), cpu.id ) )
+                cpus.push_back( cpu );
+        }
+        return cpus;
+    }
+
+    // A worker placed on `cpu` gets pinned to exactly that CPU (one-per-core
+    // placement: keeping off the core's SMT siblings) or to the allowed part
+    // of its LLC domain.
+    shop::cpu_affinity_mask placement_mask( thrd_lite::cpu_id_t const cpu, std::span<thrd_lite::cpu_id_t const> const allowed, bool const exact_cpu )
+    {
+        shop::cpu_affinity_mask mask;
+        if ( exact_cpu )
+        {
+            mask.add_cpu( cpu );
+            return mask;
+        }
+        for ( auto const domain_cpu : thrd_lite::llc_domain_cpus( cpu ) )
+        {
+            if ( allowed.empty() || std::binary_search( allowed.begin(), allowed.end(), domain_cpu ) )
+                mask.add_cpu( domain_cpu );
+        }
+        return mask;
+    }
+} // anonymous namespace
+#endif // PSI_SWEATER_TOPOLOGY
 
 auto shop::worker_loop( [[ maybe_unused ]] hardware_concurrency_t const worker_index ) noexcept
 {
@@ -159,7 +285,7 @@ auto shop::worker_loop( [[ maybe_unused ]] hardware_concurrency_t const worker_i
 #           ifdef __linux__
             parent.pool_[ worker_index ].thread_id_ = ::gettid();
 #           endif // linux
-            auto       & __restrict producer_token{                                   parent.pool_[ worker_index ].token_                          };
+            auto       & __restrict own_slot      {                                   parent.pool_[ worker_index ]                                 };
 #           ifdef __ANDROID__
             auto       & __restrict work_event    { !thrd_lite::slow_thread_signals ? parent.pool_[ worker_index ].event_ : parent.work_semaphore_ };
 #           else
@@ -168,62 +294,185 @@ auto shop::worker_loop( [[ maybe_unused ]] hardware_concurrency_t const worker_i
 #       else // PSI_SWEATER_EXACT_WORKER_SELECTION
             auto       & __restrict work_event    { parent.work_semaphore_ };
 #       endif // PSI_SWEATER_EXACT_WORKER_SELECTION
-            auto       & __restrict queue         { parent.queue_  };
-            auto const & __restrict exit          { parent.brexit_ };
+            auto       & __restrict queue         { parent.queue_        };
+            auto       & __restrict spread_queue  { parent.spread_queue_ };
+            auto const & __restrict exit          { parent.brexit_       };
 
-            auto consumer_token{ queue.consumer_token() };
+            auto        consumer_token{        queue.consumer_token() };
+            auto spread_consumer_token{ spread_queue.consumer_token() };
 
             work_t work;
+#       if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+            idle_gap_history idle_history;
+#       endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+
+#       if PSI_SWEATER_HAS_BLOCKING_REGION
+            current_slot = { &parent, worker_index };
+#       endif // PSI_SWEATER_HAS_BLOCKING_REGION
+#       if PSI_SWEATER_TOPOLOGY
+            // Self-pinning (thread_id_ is published by this very thread so
+            // create_pool() cannot bind_worker() the fresh threads itself).
+            auto const & worker{ parent.pool_[ worker_index ] };
+            if ( worker.placement_ )
+                (void)parent.bind_worker( worker_index, *worker.placement_ ); // best effort (can be refused by a cpuset)
+#       endif // PSI_SWEATER_TOPOLOGY
+#       if PSI_SWEATER_EXACT_WORKER_SELECTION
+            name_active_thread( parent.options_.thread_name_prefix, worker_index );
+#       else
+            if ( !parent.options_.thread_name_prefix.empty() )
+                (void)thrd_lite::thread::set_active_thread_name( parent.options_.thread_name_prefix.c_str() );
+#       endif // PSI_SWEATER_EXACT_WORKER_SELECTION
 
             // One-shot per-worker init hook (weak no-op unless a consumer
             // overrides it — e.g. rama installs mimalloc's mi_thread_init).
             events::worker_thread_init( worker_index );
 
-            for ( ; ; )
+            // Helping waits on thrd_lite futures from within the pool (e.g. a
+            // dispatch_lite().get_helping() in a work item) run queued items
+            // instead of parking the worker (see help_waiting_worker()).
+            struct helper_context_t
+            {
+                shop                 & parent      ;
+                hardware_concurrency_t worker_index;
+            } helper_context{ parent, worker_index };
+            thrd_lite::wait_helper const helper
+            {
+                []( void * const p_context ) noexcept
+                {
+                    auto const & context{ *static_cast<helper_context_t const *>( p_context ) };
+                    return context.parent.help_waiting_worker( context.worker_index );
+                },
+                &helper_context
+            };
+
+            // Completions are retired from the work item count in batches
+            // (one RMW per completion_batch items rather than per item). The
+            // overcount is not harmless everywhere: spread_work() partitions
+            // by the spread item count (free workers, the direct dispatch
+            // paths, queue_and_wait) so spread completions stay batched only
+            // while the worker runs slices back to back - they are retired
+            // as soon as it runs out of them (before it turns to fire items
+            // or goes idle). Fire completions may stay batched until the
+            // worker goes idle: only number_of_items() counts them. Items
+            // themselves are still dequeued one at a time: a bulk dequeue
+            // would hoard the rest of the batch behind the running item -
+            // lost parallelism for long items and a deadlock for an item
+            // that waits for a sibling (e.g. a dispatch().get() from within
+            // the pool).
+            hardware_concurrency_t completed[ 2 ]{};
+            auto const retire{ [ & ]( work_kind const kind ) noexcept
+            {
+                auto & kind_completed{ completed[ static_cast<std::uint8_t>( kind ) ] };
+                if ( kind_completed )
+                {
+                    parent.work_completed( kind, kind_completed );
+                    kind_completed = 0;
+                }
+            } };
+            auto const run{ [ & ]( work_kind const kind ) noexcept
+            {
+                events::worker_work_begin( worker_index );
+                work();
+                if ( ++completed[ static_cast<std::uint8_t>( kind ) ] == completion_batch )
+                    retire( kind );
+                events::worker_work_end  ( worker_index );
+            } };
+            // Spread slices before fire_and_forget items (see work_kind) -
+            // and back to the worker's own slices after every fire item.
+            auto const own_spread_slices{ [ & ]() noexcept
             {
 #           if PSI_SWEATER_EXACT_WORKER_SELECTION
                 while
                 (
                     !thrd_lite::slow_thread_signals &&
-                    PSI_LIKELY( queue.dequeue_from_producer( work, *producer_token ) )
+                    PSI_LIKELY( own_slot.dequeue_spread( work, spread_queue ) )
                 ) [[ likely ]]
                 {
-                    events::worker_work_begin( worker_index );
-                    work();
-                    parent.work_completed();
-                    events::worker_work_end  ( worker_index );
+                    run( work_kind::spread );
                 }
 #           endif // EWS
+            } };
+            auto const next_fire_item{ [ & ]() noexcept
+            {
+#           if PSI_SWEATER_EXACT_WORKER_SELECTION
+                if ( !thrd_lite::slow_thread_signals && own_slot.dequeue_fire( work, queue ) )
+                    return true;
+#           endif // EWS
+#           if PSI_SWEATER_TOPOLOGY
+                for ( auto sibling{ worker.node_begin_ }; sibling < worker.node_end_; ++sibling )
+                {
+                    if ( ( sibling != worker_index ) && parent.pool_[ sibling ].dequeue_fire( work, queue ) )
+                        return true;
+                }
+#           endif // PSI_SWEATER_TOPOLOGY
+                return queue.dequeue( work, consumer_token );
+            } };
+
+            for ( ; ; )
+            {
+                (void)parent.join_open_region(); // (first: the rest of the team is waiting)
+                own_spread_slices();
+#           if PSI_SWEATER_TOPOLOGY
+                // Node-local stealing: drain the token queues of same-node
+                // siblings before the cross-node (any producer) pass below.
+                for ( auto sibling{ worker.node_begin_ }; sibling < worker.node_end_; ++sibling )
+                {
+                    if ( sibling == worker_index )
+                        continue;
+                    while ( parent.pool_[ sibling ].dequeue_spread( work, spread_queue ) )
+                        run( work_kind::spread );
+                }
+#           endif // PSI_SWEATER_TOPOLOGY
                 // Work stealing for EWS
-                while ( queue.dequeue( work, consumer_token ) ) [[ likely ]]
+                while ( spread_queue.dequeue( work, spread_consumer_token ) ) [[ likely ]]
+                {
+                    run( work_kind::spread );
+                }
+                retire( work_kind::spread );
+                while ( next_fire_item() )
                 {
-                    events::worker_work_begin( worker_index );
-                    work();
-                    parent.work_completed();
-                    events::worker_work_end  ( worker_index );
+                    run( work_kind::fire );
+                    own_spread_slices();
+                    retire( work_kind::spread ); // (a fire backlog must not hold up the spread count - see retire)
                 }
+                retire( work_kind::fire   );
+                retire( work_kind::spread );
 
                 if ( PSI_UNLIKELY( exit.load( std::memory_order_relaxed ) ) )
                     return;
+#           if PSI_SWEATER_TRACK_CPU_LIMITS
+                parent.check_cpu_limits(); // (going idle: off every critical path)
+#           endif // PSI_SWEATER_TRACK_CPU_LIMITS
                 events::worker_sleep_begin( worker_index );
 #           if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
-                work_event.wait( worker_spin_count );
+                auto const spin_count{ parent.options_.worker_spin_count };
+                if ( parent.options_.adaptive_spin )
+                {
+                    auto const idle_begin{ std::chrono::steady_clock::now() };
+                    parent.wait_for_work( worker_index, work_event, idle_history.spin() ? spin_count : 0 );
+                    idle_history.record( nanoseconds_since( idle_begin ), spin_count );
+                }
+                else
+                {
+                    parent.wait_for_work( worker_index, work_event, spin_count );
+                }
 #           else
-                work_event.wait();
+                parent.wait_for_work( worker_index, work_event, 0 );
 #           endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
                 events::worker_sleep_end  ( worker_index );
 #           if PSI_SWEATER_EXACT_WORKER_SELECTION
-                // Freshly woken with work still in flight: continue the spread
-                // wake tree (see propagate_spread_wake) before starting to
-                // consume. Keyed off the shop-wide item counter, NOT the
-                // queue's own view: moodycamel consumers can observe a
-                // spuriously empty queue while token-enqueued items exist,
-                // and a false negative here can strand a sleeping worker
-                // whose token items the (also-fallible) stealing consumers
-                // never reach -- a join deadlock (caught by TSan-scheduled
-                // stress runs). A false POSITIVE (counter > 0 for work that
-                // is merely executing) just costs two redundant notifies.
-                if ( !thrd_lite::slow_thread_signals && parent.number_of_items() != 0 )
+                // Freshly woken: continue the spread wake tree (see
+                // propagate_spread_wake) before starting to consume. Its
+                // work-in-flight check is keyed off the shop-wide item
+                // counter, NOT the queue's own view: moodycamel consumers can
+                // observe a spuriously empty queue while token-enqueued items
+                // exist, and a false negative here can strand a sleeping
+                // worker whose token items the (also-fallible) stealing
+                // consumers never reach -- a join deadlock (caught by
+                // TSan-scheduled stress runs). A false POSITIVE (counter > 0
+                // for work that is merely executing) just costs a few
+                // redundant notifies.
+                if ( !thrd_lite::slow_thread_signals )
                     parent.propagate_spread_wake( worker_index );
 #           endif // EWS
             }
@@ -248,11 +497,149 @@ auto shop::number_of_worker_threads() const noexcept
     return worker_threads;
 }
 
-shop::shop()
+// Only fire items (the worker's own lanes before the shared queue), an item
+// at a time: what a waited for child of a worker (a dispatch()) is. Spread
+// slices are left to the spreads' own workers and joins (and
+// parallel_region() members, which are not queued at all, to idle workers -
+// see parallel_region_work()). Completions are retired immediately (the
+// helped wait may well be for this very item).
+bool shop::help_waiting_worker( [[ maybe_unused ]] hardware_concurrency_t const worker_index ) noexcept
+{
+    work_t work;
+#if PSI_SWEATER_EXACT_WORKER_SELECTION
+    auto const lanes{ !thrd_lite::slow_thread_signals }; // (see create_pool())
+    if ( !( lanes && pool_[ worker_index ].dequeue_fire( work, queue_ ) ) && !queue_.dequeue( work ) )
+#else
+    if ( !queue_.dequeue( work ) )
+#endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+        return false;
+    events::worker_work_begin( worker_index );
+    work();
+    work_completed( work_kind::fire );
+    events::worker_work_end  ( worker_index );
+    return true;
+}
+
+// Parks on the work event (spinning for spin_count iterations first) - with
+// eventcount parking on the idle_workers_ eventcount at the same time:
+// anonymous fire wake-ups (see enqueue_fire()) and whole-pool broadcasts
+// (wake_all_workers()) come through the latter, targeted ones (the spread
+// wake tree, blocking region hand-offs, pop_idle()) through the event. Once
+// prepared, the eventcount's condition (anything queued or a region to
+// join?) is re-checked before spinning or parking.
+void shop::wait_for_work( [[ maybe_unused ]] hardware_concurrency_t const slot, thrd_lite::semaphore & __restrict event, std::uint32_t const spin_count ) noexcept
+{
+#if PSI_SWEATER_EVENTCOUNT_PARKING
+    if ( eventcount_parking_ ) [[ likely ]]
+    {
+        auto const key{ idle_workers_.prepare_wait() };
+        push_idle( slot );
+        if ( !spread_queue_.empty() || !queue_.empty() || region_openings_.load( std::memory_order_relaxed ) || event.try_wait( spin_count, idle_workers_.epoch(), key ) )
+            idle_workers_.cancel_wait();
+        else
+            idle_workers_.commit_wait( key, [ & ]() noexcept { (void)event.wait( idle_workers_.epoch(), key ); } );
+        pool_[ slot ].idle_.leave();
+        return;
+    }
+#endif // PSI_SWEATER_EVENTCOUNT_PARKING
+#if PSI_SWEATER_EXACT_WORKER_SELECTION
+    if ( !thrd_lite::slow_thread_signals )
+    {
+        push_idle( slot );
+        event.wait( spin_count );
+        pool_[ slot ].idle_.leave();
+        return;
+    }
+#endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+    event.wait( spin_count );
+}
+
+PSI_COLD
+bool shop::options::load_profile( char const * const file_path ) noexcept
+{
+    auto const file{ std::fopen( file_path, "r" ) };
+    if ( !file )
+        return false;
+    char line[ 256 ];
+    while ( std::fgets( line, sizeof( line ), file ) )
+    {
+        char               key[ 64 ];
+        unsigned long long value;
+        if ( std::sscanf( line, " %63[a-z_] = %llu", key, &value ) != 2 ) // (also skips comments and blank lines)
+            continue;
+        auto const set{ [ value ]<typename Field>( Field & field ) noexcept { field = static_cast<Field>( std::min<unsigned long long>( value, std::numeric_limits<Field>::max() ) ); } };
+        std::string_view const name{ key };
+#   if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+        if ( name == "worker_spin_count"     ) set( worker_spin_count     );
+#   if PSI_SWEATER_USE_CALLER_THREAD
+        if ( name == "caller_spin_count"     ) set( caller_spin_count     );
+#   endif // PSI_SWEATER_USE_CALLER_THREAD
+#   endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+        if ( name == "stealing_division_min" ) set( stealing_division_min );
+        if ( name == "stealing_division_max" ) set( stealing_division_max );
+#   if PSI_SWEATER_EXACT_WORKER_SELECTION
+        if ( name == "sticky_dispatch_depth" ) set( sticky_dispatch_depth );
+        if ( name == "wake_tree_arity"       ) set( wake_tree_arity       );
+#   endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+#   if PSI_SWEATER_USE_PARALLELIZATION_COST
+        if ( name == "min_parallel_grain"    ) set( min_parallel_grain    );
+#   endif // PSI_SWEATER_USE_PARALLELIZATION_COST
+    }
+    BOOST_VERIFY( std::fclose( file ) == 0 );
+    // (profiles are written for other builds/versions too: sanitize)
+    stealing_division_max = std::clamp<std::uint8_t>( stealing_division_max, 1, stealing_division_limit );
+    stealing_division_min = std::clamp<std::uint8_t>( stealing_division_min, 1, stealing_division_max  );
+#if PSI_SWEATER_EXACT_WORKER_SELECTION
+    wake_tree_arity       = std::max<std::uint8_t>( wake_tree_arity, 1 );
+#endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+#if PSI_SWEATER_USE_PARALLELIZATION_COST
+    min_parallel_grain    = std::max<iterations_t>( min_parallel_grain, 1 );
+#endif // PSI_SWEATER_USE_PARALLELIZATION_COST
+    return true;
+}
+
+PSI_COLD
+shop::options shop::options::from_environment() noexcept
+{
+    options defaults;
+    if ( auto const profile{ std::getenv( "PSI_SWEATER_PROFILE" ) }; profile && *profile )
+        (void)defaults.load_profile( profile ); // best effort: a missing profile leaves the defaults
+    return defaults;
+}
+
+shop::shop() : shop( options::from_environment() ) {}
+
+#if PSI_SWEATER_TOPOLOGY
+shop::shop( smt_policy const policy )
     :
-    consumer_token_{ queue_.consumer_token() }
+    shop
+    (
+        [ policy ]() noexcept
+        {
+            auto config{ options::from_environment() };
+            config.smt = policy;
+            return config;
+        }()
+    )
+{}
+#endif // PSI_SWEATER_TOPOLOGY
+
+shop::shop( options config )
+    :
+    options_          { std::move( config )            },
+    stealing_division_{ options_.stealing_division_min }
 {
-#ifdef __GNUC__ // compilers with init_priority attribute (see hardware_concurency.hpp)
+    BOOST_ASSERT_MSG
+    (
+        ( options_.stealing_division_min > 0 ) &&
+        ( options_.stealing_division_min <= options_.stealing_division_max ) &&
+        ( options_.stealing_division_max <= options::stealing_division_limit ),
+        "Invalid work stealing division bounds"
+    );
+#if PSI_SWEATER_TRACK_CPU_LIMITS
+    // The quota is tracked at runtime (see refresh_cpu_limits()).
+    hardware_concurrency_t local_hardware_concurrency( thrd_lite::get_hardware_concurrency_unlimited() );
+#elif defined( __GNUC__ ) // compilers with init_priority attribute (see hardware_concurency.hpp)
     hardware_concurrency_t local_hardware_concurrency( thrd_lite::hardware_concurrency_max );
 #else
     /// \note Avoid the static-initialization-order-fiasco (for compilers
@@ -262,6 +649,37 @@ shop::shop()
     ///                                   (01.05.2017.) (Domagoj Saric)
     hardware_concurrency_t local_hardware_concurrency( thrd_lite::get_hardware_concurrency_max() );
 #endif // __GNUC__
+#if PSI_SWEATER_TOPOLOGY
+    std::sort( options_.cpus.begin(), options_.cpus.end() );
+    options_.cpus.erase( std::unique( options_.cpus.begin(), options_.cpus.end() ), options_.cpus.end() );
+    if ( ( options_.smt == smt_policy::one_per_core ) || !options_.cpus.empty() )
+    {
+        // The cores (one_per_core) and/or CPUs of the requested set (not
+        // restricted by the current affinity: the workers are placed over
+        // its allowed part and can follow it as it changes).
+        auto const cpus{ thrd_lite::cpu_topology() };
+        auto const usable
+        {
+            static_cast<hardware_concurrency_t>
+            (
+                std::count_if
+                (
+                    cpus.begin(), cpus.end(),
+                    [ this ]( thrd_lite::cpu_info const & cpu ) noexcept
+                    {
+                        return
+                            ( ( options_.smt != smt_policy::one_per_core ) || !cpu.smt_index ) &&
+                            ( options_.cpus.empty() || std::binary_search( options_.cpus.begin(), options_.cpus.end(), cpu.id ) );
+                    }
+                )
+            )
+        };
+        if ( usable ) // (no topology information: assume no SMT, ignore the set)
+            local_hardware_concurrency = std::min( local_hardware_concurrency, usable );
+    }
+#endif // PSI_SWEATER_TOPOLOGY
+    if ( options_.threads )
+        local_hardware_concurrency = std::min( options_.threads, thrd_lite::get_hardware_concurrency_unlimited() );
 #if PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
     /// \note Fail-safe for possible future devices that may overflow
     /// PSI_SWEATER_MAX_HARDWARE_CONCURRENCY or for cases like running an
@@ -270,11 +688,174 @@ shop::shop()
     local_hardware_concurrency = std::min<hardware_concurrency_t>( local_hardware_concurrency, PSI_SWEATER_MAX_HARDWARE_CONCURRENCY );
 #endif
     BOOST_ASSUME( local_hardware_concurrency > 0 );
+#if PSI_SWEATER_HMP && PSI_SWEATER_TOPOLOGY
+    // (only for the whole machine: the cluster configuration describes it;
+    // the startup quota counts too even where it is otherwise tracked at
+    // runtime instead)
+    if ( !options_.threads && options_.cpus.empty() && configure_hmp_from_topology( std::min( local_hardware_concurrency, thrd_lite::get_hardware_concurrency_max() ) ) )
+        return;
+#endif
+#if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+    if ( options_.adaptive_spin )
+        (void)spin_iteration_picoseconds(); // (measure before there are workers to disturb it)
+#endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
     create_pool( local_hardware_concurrency - PSI_SWEATER_USE_CALLER_THREAD );
 }
 
 shop::~shop() noexcept { stop_and_destroy_pool(); }
 
+std::uint64_t shop::new_id() noexcept
+{
+    static std::atomic<std::uint64_t> last_id{ 0 };
+    return last_id.fetch_add( 1, std::memory_order_relaxed ) + 1;
+}
+
+// Concurrent spreads used to serialize their caller stealing on a single
+// shared token (and its lock). Each caller thread now keeps a few tokens,
+// one per shop it recently spread on: keyed by the never reused shop id_ (not
+// the address) - entries of destroyed shops are thus never matched again,
+// only overwritten (consumer tokens, unlike producer tokens, hold nothing
+// owned by the queue and are safe to outlive it unused).
+shop::my_queue::consumer_token_t & shop::caller_consumer_token() noexcept
+{
+    struct cached_token
+    {
+        std::uint64_t                             shop_id{ 0 };
+        std::optional<my_queue::consumer_token_t> token;
+    }; // struct cached_token
+    // (Entries can get evicted by any other shop's call: the returned
+    // reference must not be held across running items.)
+    thread_local std::array<cached_token, 4> cache;
+    thread_local std::uint8_t                next_victim{ 0 };
+    for ( auto & entry : cache )
+    {
+        if ( entry.shop_id == id_ ) [[ likely ]]
+            return *entry.token;
+    }
+    auto & entry{ cache[ next_victim++ % cache.size() ] };
+    entry.shop_id = id_;
+    entry.token.emplace( spread_queue_.consumer_token() );
+    return *entry.token;
+}
+
+hardware_concurrency_t shop::active_worker_threads() const noexcept
+{
+#if PSI_SWEATER_TRACK_CPU_LIMITS
+    auto const active{ active_workers_.load( std::memory_order_relaxed ) };
+    BOOST_ASSUME( active <= number_of_worker_threads() );
+    return active;
+#else
+    return number_of_worker_threads();
+#endif
+}
+
+hardware_concurrency_t shop::number_of_active_workers() const noexcept
+{
+    return static_cast<hardware_concurrency_t>( active_worker_threads() + PSI_SWEATER_USE_CALLER_THREAD );
+}
+
+#if PSI_SWEATER_TRACK_CPU_LIMITS
+namespace
+{
+    auto constexpr cpu_limits_check_period{ std::chrono::seconds( 1 ) };
+} // anonymous namespace
+
+// The caller thread counts against the limit like any worker (it does its
+// share of every spread) - hence a quota (or a CPU set) of N leaves N-1
+// active workers.
+// Shrinking leaves the remaining workers' placement (and so cache locality)
+// intact as the lowest worker indices stay active.
+// (The CPU set is the process's - its cpuset - and not the affinity of any
+// one of its threads: a user thread pinning itself, as the caller of a spread
+// often does, leaves the pool alone.)
+PSI_COLD
+void shop::refresh_cpu_limits() noexcept
+{
+    std::scoped_lock<thrd_lite::spin_lock> const lock{ limits_mutex_ };
+    auto const pool_size{ number_of_worker_threads() };
+    auto       allowed  { static_cast<hardware_concurrency_t>( pool_size + PSI_SWEATER_USE_CALLER_THREAD ) };
+    if ( auto const quota{ thrd_lite::cpu_quota_current() } )
+        allowed = std::min( allowed, quota );
+    if ( auto const cpus{ thrd_lite::cpus_allowed_current() } )
+        allowed = std::min( allowed, cpus );
+    if ( cpu_limit_ )
+        allowed = std::min( allowed, cpu_limit_ );
+    active_workers_.store( static_cast<hardware_concurrency_t>( std::max( 0, allowed - PSI_SWEATER_USE_CALLER_THREAD ) ), std::memory_order_relaxed );
+#if PSI_SWEATER_TOPOLOGY
+    follow_affinity_changes();
+#endif // PSI_SWEATER_TOPOLOGY
+}
+
+PSI_COLD
+void shop::limit_cpus( hardware_concurrency_t const cpus ) noexcept
+{
+    {
+        std::scoped_lock<thrd_lite::spin_lock> const lock{ limits_mutex_ };
+        cpu_limit_ = cpus;
+    }
+    refresh_cpu_limits();
+}
+
+#if PSI_SWEATER_TOPOLOGY
+// Re-pins the (started) workers when the process's CPU set changed since the
+// last check: pinning done for the old set would otherwise keep workers on
+// CPUs the process no longer owns (the cpuset of a resized container) or off
+// the newly granted ones. Workers get the placement a new pool would: the
+// same worker-index order over the new set.
+PSI_COLD
+void shop::follow_affinity_changes() noexcept
+{
+    BOOST_TRY
+    {
+        auto const allowed{ placement_allowed_cpus() };
+        if ( allowed.empty() )
+            return;
+        std::uint64_t signature{ 14695981039346656037ULL }; // FNV-1a
+        for ( auto const cpu : allowed )
+            signature = ( signature ^ cpu ) * 1099511628211ULL;
+        auto const previous_signature{ std::exchange( affinity_signature_, signature ) };
+        if ( !previous_signature || ( previous_signature == signature ) ) // (the first check only records the set create_pool() placed the workers for)
+            return;
+
+        auto const one_per_core{ ( options_.smt == smt_policy::one_per_core ) && has_smt() };
+        auto const cpus        { placement_cpus( allowed, one_per_core ) };
+        for ( hardware_concurrency_t worker_index{ 0 }; worker_index < number_of_worker_threads(); ++worker_index )
+        {
+            auto const & worker{ pool_[ worker_index ] };
+            if ( !worker.thread_id_ ) // not started yet: will pin itself
+                continue;
+            cpu_affinity_mask mask;
+            if ( worker.placement_ && !cpus.empty() )
+            {
+                mask = placement_mask( cpus[ ( worker_index + PSI_SWEATER_USE_CALLER_THREAD ) % cpus.size() ].id, allowed, one_per_core );
+            }
+            else
+            {
+                for ( auto const cpu : allowed )
+                    mask.add_cpu( cpu );
+            }
+            (void)bind_worker( worker_index, mask );
+        }
+    }
+    BOOST_CATCH( ... ) {} // best effort
+    BOOST_CATCH_END
+}
+#endif // PSI_SWEATER_TOPOLOGY
+
+// Claims the (at most once per period) refresh - so that of the workers
+// going idle at the same time only one pays for the cgroupfs reads.
+void shop::check_cpu_limits() noexcept
+{
+    auto const now     { std::chrono::steady_clock::now().time_since_epoch().count() };
+    auto       deadline{ next_limits_check_.load( std::memory_order_relaxed ) };
+    if ( PSI_LIKELY( now < deadline ) )
+        return;
+    auto const next_deadline{ now + std::chrono::duration_cast<std::chrono::steady_clock::duration>( cpu_limits_check_period ).count() };
+    if ( next_limits_check_.compare_exchange_strong( deadline, next_deadline, std::memory_order_relaxed ) )
+        refresh_cpu_limits();
+}
+#endif // PSI_SWEATER_TRACK_CPU_LIMITS
+
 hardware_concurrency_t shop::number_of_workers() const noexcept
 {
     auto const actual_number_of_workers{ number_of_worker_threads() + PSI_SWEATER_USE_CALLER_THREAD };
@@ -304,8 +885,8 @@ bool shop::set_priority( thrd_lite::priority const new_priority ) noexcept
     if ( !success )
     {
 #   if PSI_SWEATER_HMP // Disable HMP to get all workers queried
-        auto hmp_setting{ hmp };
-        hmp = false;
+        auto hmp_setting{ hmp_ };
+        hmp_ = false;
 #   endif // PSI_SWEATER_HMP
 #   if PSI_SWEATER_USE_CALLER_THREAD
         auto const caller_id{ ::gettid() };
@@ -329,7 +910,7 @@ bool shop::set_priority( thrd_lite::priority const new_priority ) noexcept
             }
         );
 #   if PSI_SWEATER_HMP
-        hmp = hmp_setting;
+        hmp_ = hmp_setting;
 #   endif // PSI_SWEATER_HMP
     }
 #endif // __linux
@@ -353,8 +934,8 @@ bool shop::bind_worker
         succeeded |= thrd_lite::thread::bind_to_cpu( thread.thread_id_, mask );
 #       else
 #       if PSI_SWEATER_HMP // Disable HMP to get all workers queried
-        auto hmp_setting{ hmp };
-        hmp = false;
+        auto hmp_setting{ hmp_ };
+        hmp_ = false;
 #       endif // PSI_SWEATER_HMP
         int result{ 2 };
         spread_the_sweat
@@ -372,7 +953,7 @@ bool shop::bind_worker
             }
         );
 #       if PSI_SWEATER_HMP
-        hmp = hmp_setting;
+        hmp_ = hmp_setting;
 #       endif // PSI_SWEATER_HMP
         BOOST_ASSERT( result != 2 );
         succeeded |= ( result == 0 );
@@ -397,75 +978,301 @@ bool shop::bind_worker_to_cpu( hardware_concurrency_t const worker_index, unsign
 PSI_COLD
 void shop::set_max_allowed_threads( hardware_concurrency_t const max_threads )
 {
-    BOOST_ASSERT_MSG( queue_.empty(), "Cannot change parallelism level while items are in queue."    );
-    BOOST_ASSERT_MSG( !hmp          , "Cannot change number of workers directly when HMP is enabled" );
+    BOOST_ASSERT_MSG( queue_.empty() && spread_queue_.empty(), "Cannot change parallelism level while items are in queue." );
+    // (HMP partitioning disengages while the pool size differs from the one
+    // the cluster configuration was made for - see spread_work().)
     stop_and_destroy_pool();
     create_pool( max_threads - PSI_SWEATER_USE_CALLER_THREAD );
 }
 
-hardware_concurrency_t shop::number_of_items() const noexcept
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+shop::blocking_region::blocking_region( shop & parent ) noexcept : shop_{ parent }, p_spare_{ parent.begin_blocking() } {}
+shop::blocking_region::~blocking_region(              ) noexcept { if ( p_spare_ ) shop_.end_blocking( *p_spare_ ); }
+
+PSI_COLD
+shop::spare_thread * shop::begin_blocking() noexcept
+{
+    auto const serving{ current_slot };
+    if ( ( serving.p_shop != this ) || thrd_lite::slow_thread_signals )
+        return nullptr;
+    auto & worker{ pool_[ serving.slot ] };
+    for ( auto & spare : std::span{ spares_.get(), pool_.size() } )
+    {
+        if ( spare.busy_.exchange( true, std::memory_order_acquire ) )
+            continue;
+        if ( !spare.joinable() )
+        {
+            spare.p_shop_ = this;
+            BOOST_TRY
+            {
+                spare.start( [ p_spare = &spare ]() noexcept { p_spare->p_shop_->spare_loop( *p_spare ); }, options_.stack_size );
+            }
+            BOOST_CATCH( ... )
+            {
+                spare.busy_.store( false, std::memory_order_release );
+                break;
+            }
+            BOOST_CATCH_END
+        }
+        spare.slot_ = serving.slot;
+        worker.blocked_.fetch_add( 1, std::memory_order_acq_rel );
+        current_slot = {}; // nested regions are no-ops
+        events::worker_blocking_begin( serving.slot, true );
+        spare.event_.signal();
+        return &spare;
+    }
+    // Out of spares (or threads): the slot stays unserved until the region
+    // ends - other workers can still steal its queued items.
+    events::worker_blocking_begin( serving.slot, false );
+    return nullptr;
+}
+
+PSI_COLD
+void shop::end_blocking( spare_thread & spare ) noexcept
+{
+    auto const slot{ spare.slot_ };
+    current_slot = { this, slot };
+    events::worker_blocking_end( slot );
+    if ( pool_[ slot ].blocked_.fetch_sub( 1, std::memory_order_acq_rel ) != 1 )
+        return;
+    // The slot is unblocked: wake whoever may be parked on its event - the
+    // spares still serving it (so that they can retire) and the worker. One
+    // signal per waiter: worker events take single tokens only (see
+    // semaphore::signal()).
+    hardware_concurrency_t waiters{ 1 };
+    for ( auto const & other : std::span{ spares_.get(), pool_.size() } )
+        waiters += other.busy_.load( std::memory_order_relaxed ) && ( other.slot_ == slot );
+    while ( waiters-- )
+        pool_[ slot ].event_.signal();
+}
+
+PSI_COLD
+void shop::spare_loop( spare_thread & spare ) noexcept
+{
+    name_active_thread( options_.thread_name_prefix, static_cast<unsigned>( pool_.size() + ( &spare - spares_.get() ) ) ); // (numbered after the workers)
+    auto        consumer_token{        queue_.consumer_token() };
+    auto spread_consumer_token{ spread_queue_.consumer_token() };
+    work_t work;
+    for ( ; ; )
+    {
+        spare.event_.wait(); // retired until the next handoff
+        if ( PSI_UNLIKELY( brexit_.load( std::memory_order_relaxed ) ) )
+            return;
+        auto const slot  { spare.slot_   };
+        auto       & worker{ pool_[ slot ] };
+        current_slot = { this, slot };
+        while ( worker.blocked_.load( std::memory_order_acquire ) )
+        {
+            (void)join_open_region();
+            for ( ; ; )
+            {
+                work_kind kind;
+                if ( worker.dequeue_spread( work, spread_queue_ ) || spread_queue_.dequeue( work, spread_consumer_token ) )
+                    kind = work_kind::spread;
+                else
+                if ( worker.dequeue_fire( work, queue_ ) || queue_.dequeue( work, consumer_token ) )
+                    kind = work_kind::fire;
+                else
+                    break;
+                events::worker_work_begin( slot );
+                work();
+                work_completed( kind );
+                events::worker_work_end  ( slot );
+            }
+            if ( PSI_UNLIKELY( brexit_.load( std::memory_order_relaxed ) ) )
+                return;
+            if ( !worker.blocked_.load( std::memory_order_acquire ) )
+                break;
+            events::worker_sleep_begin( slot );
+#       if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+            wait_for_work( slot, worker.event_, options_.worker_spin_count );
+#       else
+            wait_for_work( slot, worker.event_, 0 );
+#       endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+            events::worker_sleep_end  ( slot );
+            propagate_spread_wake( slot ); // the slot's wake tree duties (see worker_loop)
+        }
+        current_slot = {};
+        spare.busy_.store( false, std::memory_order_release );
+    }
+}
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
+
+// Sharded (see work_item_counters) - at a single counter every item's add
+// and completion RMW contended for one cache line with every worker and
+// producer. The query pays a load per shard instead, and is made only once
+// per spread and per worker wake-up. Completions are read first: an item
+// whose completion is counted has its addition (which happened-before it)
+// counted as well, so the result never understates the items in flight (the
+// spread wake tree relies on that - see propagate_spread_wake()) - except
+// for the fire path's late addition (see work_added()), as before.
+hardware_concurrency_t shop::number_of_items       () const noexcept { return number_of_items( false ); }
+hardware_concurrency_t shop::number_of_spread_items() const noexcept { return number_of_items( true  ); }
+
+hardware_concurrency_t shop::number_of_items( bool const spread_only ) const noexcept
 {
 #if 0
     return queue_.depth();
 #else
-    return work_items_.load( std::memory_order_acquire );
+    auto const sum{ [ & ]( auto const counters ) noexcept
+    {
+        std::uint32_t total{ 0 };
+        for ( auto const kind : { work_kind::fire, work_kind::spread } )
+        {
+            if ( spread_only && ( kind == work_kind::fire ) )
+                continue;
+            auto const index{ static_cast<std::uint8_t>( kind ) };
+            total += ( work_items_.*counters )[ index ].load( std::memory_order_acquire );
+#       if PSI_SWEATER_EXACT_WORKER_SELECTION
+            for ( auto const & worker : pool_ )
+                total += ( worker.items_.*counters )[ index ].load( std::memory_order_acquire );
+#       endif
+        }
+        return total;
+    } };
+    auto const completed{ sum( &work_item_counters::completed_ ) };
+    auto const added    { sum( &work_item_counters::added_     ) };
+    auto const items{ static_cast<std::int32_t>( added - completed ) };
+    return static_cast<hardware_concurrency_t>( std::clamp<std::int32_t>( items, 0, std::numeric_limits<hardware_concurrency_t>::max() ) );
 #endif
 }
 
+// The counting thread's shard: its worker slot's for the threads of the
+// pool (and spares serving a slot), the shared one otherwise.
+shop::work_item_counters & shop::work_item_shard() noexcept
+{
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+    if ( current_slot.p_shop == this ) [[ likely ]]
+        return pool_[ current_slot.slot ].items_;
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
+    return work_items_;
+}
+
 #if PSI_SWEATER_HMP
 PSI_COLD
-void shop::configure_hmp( hmp_clusters_info const config, std::uint8_t const number_of_clusters )
+shop::hmp_config shop::make_hmp_config( hmp_clusters_info const & config, std::uint8_t const number_of_clusters ) noexcept
 {
     BOOST_ASSERT( number_of_clusters <= config.max_clusters );
-    hmp_clusters.number_of_clusters = number_of_clusters;
-
-    hardware_concurrency_t number_of_cores{ 0 };
-
-    float cluster_capacities[ config.max_clusters ];
-    float total_power{ 0 };
+    BOOST_ASSERT( number_of_clusters > 0 );
+    hmp_config clusters{};
+    clusters.number_of_clusters = number_of_clusters;
+
+    // Cluster 'power' (its share of the throughput) -> per-core weights,
+    // normalized so that the strongest core weighs max_weight.
+    float core_power[ config.max_clusters ];
+    float max_core_power{ 0 };
     for ( auto cluster{ 0 }; cluster < number_of_clusters; ++cluster )
     {
-        hmp_clusters.cores[ cluster ] = config.cores[ cluster ];
-        cluster_capacities[ cluster ] = config.power[ cluster ];
-        number_of_cores += hmp_clusters.cores[ cluster ];
-        total_power     += cluster_capacities[ cluster ];
+        BOOST_ASSERT( config.cores[ cluster ] > 0 );
+        clusters.cores [ cluster ] = config.cores[ cluster ];
+        core_power     [ cluster ] = config.power[ cluster ] / config.cores[ cluster ];
+        clusters.number_of_cores  += clusters.cores[ cluster ];
+        max_core_power             = std::max( max_core_power, core_power[ cluster ] );
     }
-
-    std::uint8_t final_total_power{ 0 };
     for ( auto cluster{ 0 }; cluster < number_of_clusters; ++cluster )
     {
-        hmp_clusters.power[ cluster ] = static_cast<std::uint8_t>( cluster_capacities[ cluster ] / total_power * hmp_config::max_power );
-        final_total_power += hmp_clusters.power[ cluster ];
+        clusters.core_weight[ cluster ] = static_cast<std::uint16_t>( std::max( 1.0f, core_power[ cluster ] / max_core_power * hmp_config::max_weight ) );
     }
-    BOOST_ASSERT // max integer rounding error
-    (
-        final_total_power >= ( hmp_config::max_power - ( number_of_clusters - 1 ) ) &&
-        final_total_power <= ( hmp_config::max_power + ( number_of_clusters - 1 ) )
-    );
-    auto const  overflow_err{ static_cast<std::uint8_t>( std::max( 0, final_total_power     - hmp_config::max_power ) ) };
-    auto const underflow_err{ static_cast<std::uint8_t>( std::max( 0, hmp_config::max_power - final_total_power     ) ) };
-    hmp_clusters.power[ number_of_clusters - 1 ] -=  overflow_err;
-    hmp_clusters.power[ 0                      ] += underflow_err;
+    return clusters;
+}
 
-    final_total_power -=  overflow_err;
-    final_total_power += underflow_err;
-    BOOST_ASSERT( final_total_power == hmp_config::max_power );
+PSI_COLD
+void shop::configure_hmp( hmp_clusters_info const config, std::uint8_t const number_of_clusters )
+{
+    hmp_clusters_ = make_hmp_config( config, number_of_clusters );
+    hmp_          = !thrd_lite::slow_thread_signals;
+
+    create_pool( hmp_clusters_.number_of_cores - PSI_SWEATER_USE_CALLER_THREAD );
+}
+
+// The parts go to the strongest cores first and each cluster gets a share of
+// the iterations proportional to its used cores' combined weight (computed
+// from running totals so the shares add up exactly, leaving no rounding
+// leftovers to patch up). A weak cluster's share can be smaller than its
+// number of (used) cores - it is then split over fewer of them.
+std::uint8_t shop::hmp_partition( hmp_config const & clusters, iterations_t const iterations, hardware_concurrency_t parts, hmp_share ( & shares )[ hmp_config::max_clusters ] ) noexcept
+{
+    BOOST_ASSUME( clusters.number_of_clusters <= clusters.max_clusters );
+    std::uint8_t           number_used_of_clusters{ 0 };
+    hardware_concurrency_t cluster_parts[ clusters.max_clusters ];
+    std::uint64_t          total_weight{ 0 };
+    for ( auto cluster{ 0 }; ( cluster < clusters.number_of_clusters ) && parts; ++cluster )
+    {
+        cluster_parts[ cluster ] = std::min( parts, clusters.cores[ cluster ] );
+        parts                   -= cluster_parts[ cluster ];
+        total_weight            += std::uint64_t{ cluster_parts[ cluster ] } * clusters.core_weight[ cluster ];
+        ++number_used_of_clusters;
+    }
 
-    hmp = !thrd_lite::slow_thread_signals;
+    iterations_t           iteration    { 0 };
+    hardware_concurrency_t first_worker { 0 };
+    std::uint64_t          weight_before{ 0 };
+    for ( auto cluster{ 0 }; cluster < number_used_of_clusters; ++cluster )
+    {
+        weight_before += std::uint64_t{ cluster_parts[ cluster ] } * clusters.core_weight[ cluster ];
+        auto const end_iteration{ static_cast<iterations_t>( iterations * weight_before / total_weight ) };
+        shares[ cluster ] =
+        {
+            .first_worker = first_worker,
+            .parts        = static_cast<hardware_concurrency_t>( std::min<iterations_t>( cluster_parts[ cluster ], end_iteration - iteration ) ),
+            .begin        = iteration,
+            .end          = end_iteration
+        };
+        iteration     = end_iteration;
+        first_worker += clusters.cores[ cluster ] - ( ( cluster == 0 ) && PSI_SWEATER_USE_CALLER_THREAD );
+    }
+    return number_used_of_clusters;
+}
 
-    create_pool( number_of_cores - PSI_SWEATER_USE_CALLER_THREAD );
+#if PSI_SWEATER_TOPOLOGY
+// Capacity classes of the CPUs the pool would use (the cores' primary
+// threads with smt_policy::one_per_core) become the clusters - their
+// combined capacities the cluster power. Classes beyond max_clusters are
+// folded into the last (weakest) cluster. Leaves HMP off (returns false) on
+// homogeneous machines and when the pool is limited (CPU quota, affinity,
+// PSI_SWEATER_MAX_HARDWARE_CONCURRENCY) to fewer workers than the clusters
+// have cores - which of the cores a limited pool gets to run on is unknown.
+PSI_COLD
+bool shop::configure_hmp_from_topology( hardware_concurrency_t const limit )
+{
+    hmp_clusters_info config{};
+    std::uint8_t number_of_clusters{ 0 };
+    hardware_concurrency_t number_of_cores{ 0 };
+    for ( auto const & cpu : thrd_lite::cpu_topology() )
+    {
+        if ( ( options_.smt == smt_policy::one_per_core ) && cpu.smt_index )
+            continue;
+        auto const cluster{ std::min<std::uint8_t>( cpu.capacity_class, config.max_clusters - 1 ) };
+        config.cores[ cluster ] += 1;
+        config.power[ cluster ] += cpu.capacity;
+        number_of_clusters       = std::max<std::uint8_t>( number_of_clusters, cluster + 1 );
+        ++number_of_cores;
+    }
+    if ( ( number_of_clusters < 2 ) || ( number_of_cores > limit ) )
+        return false;
+    for ( auto cluster{ 0 }; cluster < number_of_clusters; ++cluster )
+    {
+        if ( !config.cores[ cluster ] ) // (a machine with only big and little cores but capacity classes 0 and 2)
+            return false;
+    }
+    configure_hmp( config, number_of_clusters );
+    return true;
 }
+#endif // PSI_SWEATER_TOPOLOGY
 #endif // PSI_SWEATER_HMP
 
 PSI_COLD
 void shop::create_pool( hardware_concurrency_t const size )
 {
-    BOOST_ASSERT_MSG( size <= thrd_lite::get_hardware_concurrency_max(), "Requested parallelism level not offered in hardware." );
+    BOOST_ASSERT_MSG( size <= thrd_lite::get_hardware_concurrency_unlimited(), "Requested parallelism level not offered in hardware." );
     auto const current_size( pool_.size() );
     if ( size == current_size )
         return;
     stop_and_destroy_pool();
     brexit_.store( false, std::memory_order_relaxed );
+#if PSI_SWEATER_EXACT_WORKER_SELECTION
+    idle_stack_.clear();
+#endif // PSI_SWEATER_EXACT_WORKER_SELECTION
 #if PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
     pool_.resize( size );
 #else
@@ -473,28 +1280,141 @@ void shop::create_pool( hardware_concurrency_t const size )
     pool_ = { p_workers.get(), size };
 #endif // !PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
 
+#if PSI_SWEATER_TOPOLOGY
+    assign_placement();
+#endif // PSI_SWEATER_TOPOLOGY
     for ( hardware_concurrency_t worker_index{ 0 }; worker_index < size; ++worker_index )
     {
 #   if PSI_SWEATER_EXACT_WORKER_SELECTION
         if ( !thrd_lite::slow_thread_signals )
-            pool_[ worker_index ].token_.emplace( queue_.producer_token() );
+        {
+            for ( auto & lane : pool_[ worker_index ].spread_lanes_ )
+                lane.token_.emplace( spread_queue_.producer_token() );
+            for ( auto & lane : pool_[ worker_index ].fire_lanes_ )
+                lane.token_.emplace( queue_.producer_token() );
+        }
 #   endif // PSI_SWEATER_EXACT_WORKER_SELECTION
-        pool_[ worker_index ] = worker_loop( worker_index );
+        pool_[ worker_index ].start( worker_loop( worker_index ), options_.stack_size );
     }
 #if !PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
     p_workers.release();
 #endif // !PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+    if ( !thrd_lite::slow_thread_signals && size )
+        spares_ = std::make_unique<spare_thread[]>( size );
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
+#if PSI_SWEATER_TRACK_CPU_LIMITS
+    refresh_cpu_limits();
+    next_limits_check_.store( ( std::chrono::steady_clock::now() + cpu_limits_check_period ).time_since_epoch().count(), std::memory_order_relaxed );
+#endif // PSI_SWEATER_TRACK_CPU_LIMITS
     std::atomic_thread_fence( std::memory_order_seq_cst );
 }
 
+#if PSI_SWEATER_TOPOLOGY
+// Worker i is placed on the (i+1)-th CPU in the topology's locality order
+// (the first one is left to the caller thread, which thus shares caches with
+// worker 0 - the recipient of the iterations adjacent to its own). Spread
+// slices, the wake tree and the dispatch rotor all go by worker index so they
+// follow cache domains and, across NUMA nodes, memory controllers; each node
+// ends up with a contiguous range of workers which doubles as their first
+// stealing domain. Pinning is done at LLC domain granularity (tight enough
+// to keep the order meaningful, loose enough to leave the OS scheduler room
+// to balance) and only on machines with more than one such domain (hybrid
+// machines' big and little cores count as separate domains: HMP partitioning
+// relies on the workers actually running on the cores they are attributed
+// to).
+// With smt_policy::one_per_core only the cores' primary hardware threads
+// are used and each worker is pinned to exactly its CPU, on any machine that
+// has SMT (the caller thread is left unpinned - it is the user's thread).
+PSI_COLD
+void shop::assign_placement() noexcept
+{
+    auto const workers{ number_of_worker_threads() };
+    auto const one_per_core{ ( options_.smt == smt_policy::one_per_core ) && has_smt() };
+    if ( !workers )
+        return;
+    BOOST_TRY
+    {
+        auto const allowed{ placement_allowed_cpus() };
+        auto const cpus   { placement_cpus( allowed, one_per_core ) };
+        if ( cpus.empty() )
+            return;
+        auto const flat
+        {
+            std::all_of
+            (
+                cpus.begin(), cpus.end(),
+                [ & ]( thrd_lite::cpu_info const & cpu ) noexcept
+                {
+                    auto const & first{ cpus.front() };
+                    return ( cpu.l3 == first.l3 ) && ( cpu.numa_node == first.numa_node ) && ( cpu.capacity_class == first.capacity_class );
+                }
+            )
+        };
+        if ( flat && !one_per_core && options_.cpus.empty() )
+            return;
+        auto const multi_node{ cpus.front().numa_node != cpus.back().numa_node }; // sorted by node first
+        auto const nodes     { multi_node ? thrd_lite::numa_slot_ranges( cpus, workers, PSI_SWEATER_USE_CALLER_THREAD ) : std::vector<thrd_lite::slot_range>{} };
+        for ( hardware_concurrency_t worker_index{ 0 }; worker_index < workers; ++worker_index )
+        {
+            auto & worker{ pool_[ worker_index ] };
+            worker.placement_ = placement_mask( cpus[ ( worker_index + PSI_SWEATER_USE_CALLER_THREAD ) % cpus.size() ].id, allowed, one_per_core );
+            if ( multi_node )
+            {
+                worker.node_begin_ = nodes[ worker_index ].begin;
+                worker.node_end_   = nodes[ worker_index ].end  ;
+            }
+        }
+    }
+    BOOST_CATCH( ... ) {} // placement is best effort
+    BOOST_CATCH_END
+}
+
+// The process's allowed CPUs restricted to options::cpus (all of them should
+// the two sets not intersect).
+std::vector<thrd_lite::cpu_id_t> shop::placement_allowed_cpus() const
+{
+    auto allowed{ thrd_lite::allowed_cpus() };
+    if ( options_.cpus.empty() )
+        return allowed;
+    if ( allowed.empty() ) // (unknown)
+        return options_.cpus;
+    std::vector<thrd_lite::cpu_id_t> restricted;
+    std::set_intersection( allowed.begin(), allowed.end(), options_.cpus.begin(), options_.cpus.end(), std::back_inserter( restricted ) );
+    return restricted.empty() ? allowed : restricted;
+}
+#endif // PSI_SWEATER_TOPOLOGY
 
 PSI_COLD
 void shop::stop_and_destroy_pool() noexcept
 {
     brexit_.store( true, std::memory_order_relaxed );
     wake_all_workers();
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+    // Spares may be parked either on their own event (retired) or on the
+    // event of the slot they serve (which the worker itself may also be
+    // waiting on) - kick both. Workers are joined first as a worker still
+    // inside a blocking_region may yet start (and hand off to) a spare.
+    for ( auto & spare : std::span{ spares_.get(), spares_ ? pool_.size() : 0 } )
+    {
+        spare.event_.signal();
+        if ( spare.busy_.load( std::memory_order_acquire ) )
+            pool_[ spare.slot_ ].notify();
+    }
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
     for ( auto & worker : pool_ )
         worker.join();
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+    for ( auto & spare : std::span{ spares_.get(), spares_ ? pool_.size() : 0 } )
+    {
+        if ( spare.joinable() )
+        {
+            spare.event_.signal();
+            spare.join();
+        }
+    }
+    spares_.reset();
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
 #if PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
     pool_.clear();
 #else
@@ -520,7 +1440,7 @@ void shop::perform_caller_work
     completion_barrier.add_expected_arrival();
     work_added_untracked();
     caller_chunk        ();
-    work_completed      ();
+    work_completed      ( work_kind::spread );
     events::caller_work_end();
 }
 
@@ -532,9 +1452,8 @@ void shop::perform_caller_work
 // This incurrs an overhead (produces more queue traffic) which is negligible
 // compared to practical runtime speedups and it (the queue based approach) is
 // required for a dispatcher which supports concurrent and recursive dispatches.
-std::uint8_t const spread_work_stealing_division_min{  4 };
-std::uint8_t const spread_work_stealing_division_max{ 16 }; // has to be limited (among other reasons) not to overflow hardware_concurrency_t
-std::atomic<std::uint8_t> shop::spread_work_stealing_division{ spread_work_stealing_division_min };
+// The division starts at options::stealing_division_min and adapts upwards
+// (up to the max) - see the caller join in spread_work().
 
 #if PSI_SWEATER_EXACT_WORKER_SELECTION
 auto shop::dispatch_workers
@@ -549,9 +1468,10 @@ auto shop::dispatch_workers
     spread_work_template_t const &       work_part_template
 ) noexcept
 {
-    auto const stealing_division{ spread_work_stealing_division.load( std::memory_order_relaxed ) };
-    BOOST_ASSUME( stealing_division >= spread_work_stealing_division_min );
-    BOOST_ASSUME( stealing_division <= spread_work_stealing_division_max );
+    auto const first_worker     { worker_index };
+    auto const stealing_division{ stealing_division_.load( std::memory_order_relaxed ) };
+    BOOST_ASSUME( stealing_division >= 1                                 );
+    BOOST_ASSUME( stealing_division <= options::stealing_division_limit );
     auto const slice_div
     {
         static_cast<std::uint8_t>
@@ -594,10 +1514,7 @@ auto shop::dispatch_workers
             work_added_untracked();
         }
         BOOST_ASSERT( number_of_slices );
-        // Wake only the FIRST worker of this dispatch run (the wake-tree root);
-        // the rest are woken by the workers themselves (propagate_spread_wake) --
-        // off the caller's critical path.
-        BOOST_VERIFY( pool_[ worker_index ].enqueue( std::make_move_iterator( slices ), number_of_slices, queue_, /*notify:*/ work_part == 0 ) ); //...mrmlj...todo err handling
+        BOOST_VERIFY( pool_[ worker_index ].enqueue( std::make_move_iterator( slices ), number_of_slices, spread_queue_, /*notify:*/ false ) ); //...mrmlj...todo err handling
         iteration = end_iteration;
         events::worker_enqueue_end( worker_index );
         ++worker_index;
@@ -606,17 +1523,166 @@ auto shop::dispatch_workers
             slices[ slice ].~work_t();
         }
     }
+    // Wake only the FIRST worker of this dispatch run (the wake tree root);
+    // the rest are woken by the workers themselves (propagate_spread_wake) --
+    // off the caller's critical path. Only after all the slices are queued:
+    // a (spinning) worker woken earlier could find its own slices missing,
+    // pass its subtree on and park - leaving them to the stealers.
+    if ( worker_index != first_worker )
+        wake_spread_subtree( first_worker, worker_index );
 
     return std::make_pair( worker_index, iteration );
 }
+
+// A sticky spread: the first one (or one that finds the shape of the spread
+// changed) slices the parts like dispatch_workers() and assigns the slices to
+// the parts' workers, later ones replay the slices to whichever worker ran
+// them the previous time (see affinity_partitioner::record_owner()).
+shop::iterations_t shop::dispatch_sticky
+(
+    affinity_partitioner         &       partitioner,
+    iterations_t                         iteration,
+    hardware_concurrency_t         const parts,
+    iterations_t                   const iterations_per_part,
+    iterations_t                   const parts_with_extra_iteration,
+    iterations_t                   const iterations,
+    thrd_lite::barrier           &       completion_barrier,
+    spread_work_template_t const &       work_part_template
+) noexcept
+{
+    BOOST_ASSUME( parts > 0 );
+    // More parts than a layout can hold (a pool of more than max_slices
+    // workers): no stickiness, a plain dispatch.
+    if ( PSI_UNLIKELY( parts > affinity_partitioner::max_slices ) ) [[ unlikely ]]
+        return dispatch_workers( 0, iteration, parts, iterations_per_part, parts_with_extra_iteration, iterations, completion_barrier, work_part_template ).second;
+    // The owners are worker thread (pool_) indices - the caller is not one
+    // of them (with no active ones the parts still go to the first worker,
+    // as with max_work_parts).
+    auto const workers{ std::max<hardware_concurrency_t>( active_worker_threads(), 1 ) };
+    auto const reshaped
+    {
+        ( partitioner.p_shop_          != this       ) ||
+        ( partitioner.iterations_      != iterations ) ||
+        ( partitioner.first_iteration_ != iteration  ) ||
+        ( partitioner.parts_           != parts      )
+    };
+    if ( reshaped )
+    {
+        auto const stealing_division{ stealing_division_.load( std::memory_order_relaxed ) };
+        auto const slice_div
+        {
+            static_cast<std::uint8_t>
+            (
+                std::min<iterations_t>
+                ({
+                    stealing_division,
+                    std::max<iterations_t>( iterations_per_part, 1 ), // handle zero iterations_per_part
+                    static_cast<iterations_t>( std::max( affinity_partitioner::max_slices / parts, 1 ) )
+                })
+            )
+        };
+        std::uint16_t slices{ 0 };
+        auto          begin { iteration };
+        for ( hardware_concurrency_t part{ 0 }; ( part < parts ) && ( begin != iterations ); ++part )
+        {
+            auto const part_iterations{ iterations_per_part + ( part < parts_with_extra_iteration ) };
+            auto const part_slices    { std::min<iterations_t>( slice_div, part_iterations ) };
+            for ( iterations_t slice{ 0 }; slice < part_slices; ++slice )
+            {
+                BOOST_ASSUME( slices < affinity_partitioner::max_slices );
+                partitioner.slice_begin_[ slices ] = begin;
+                partitioner.slice_owner_[ slices ] = part;
+                begin += part_iterations / part_slices + ( slice < part_iterations % part_slices );
+                ++slices;
+            }
+        }
+        BOOST_ASSUME( begin == iterations );
+        partitioner.slice_begin_[ slices ] = iterations;
+        partitioner.number_of_slices_      = slices;
+        partitioner.p_shop_                = this;
+        partitioner.iterations_            = iterations;
+        partitioner.first_iteration_       = iteration;
+        partitioner.parts_                 = parts;
+    }
+
+    // Runs of consecutive slices with the same owner are enqueued together.
+    auto const number_of_slices{ partitioner.number_of_slices_ };
+#ifdef BOOST_MSVC
+    auto const slices{ static_cast<work_t *>( alloca( number_of_slices * sizeof( work_t ) ) ) };
+#else
+    alignas( work_t ) char slices_storage[ number_of_slices * sizeof( work_t ) ];
+    auto const slices{ reinterpret_cast<work_t *>( slices_storage ) };
+#endif // BOOST_MSVC
+    hardware_concurrency_t wake_end{ 0 };
+    for ( std::uint16_t run_begin{ 0 }; run_begin < number_of_slices; )
+    {
+        auto owner{ partitioner.slice_owner_[ run_begin ] };
+        if ( owner >= workers ) // the pool shrunk (CPU limits) since it was recorded
+            owner = partitioner.slice_owner_[ run_begin ] = static_cast<hardware_concurrency_t>( run_begin % workers );
+        auto run_end{ run_begin };
+        do
+        {
+            auto & work_chunk { *new ( &slices[ run_end ] ) work_t{ work_part_template } };
+            auto & chunk_setup{ work_chunk.target_as<spread_work_base>() };
+            chunk_setup.start_iteration = partitioner.slice_begin_[ run_end     ];
+            chunk_setup.  end_iteration = partitioner.slice_begin_[ run_end + 1 ];
+            BOOST_ASSERT( chunk_setup.p_completion_barrier == &completion_barrier );
+            BOOST_ASSERT( chunk_setup.start_iteration < chunk_setup.end_iteration );
+            completion_barrier.add_expected_arrival();
+            work_added_untracked();
+            ++run_end;
+        } while ( ( run_end < number_of_slices ) && ( partitioner.slice_owner_[ run_end ] == owner ) );
+        events::worker_enqueue_begin( owner, partitioner.slice_begin_[ run_begin ], partitioner.slice_begin_[ run_end ] );
+        BOOST_VERIFY( pool_[ owner ].enqueue( std::make_move_iterator( &slices[ run_begin ] ), static_cast<hardware_concurrency_t>( run_end - run_begin ), spread_queue_, /*notify:*/ false ) ); //...mrmlj...todo err handling
+        events::worker_enqueue_end( owner );
+        wake_end  = std::max( wake_end, static_cast<hardware_concurrency_t>( owner + 1 ) );
+        run_begin = run_end;
+    }
+    for ( std::uint16_t slice{ 0 }; slice < number_of_slices; ++slice )
+    {
+        slices[ slice ].~work_t();
+    }
+    // (Owners need not be contiguous any more: the whole range up to the
+    // last one gets woken.)
+    wake_spread_subtree( 0, wake_end );
+    return iterations;
+}
 #endif // PSI_SWEATER_EXACT_WORKER_SELECTION
 
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+// Run by every slice of a sticky spread (the caller's part, which always
+// stays with the caller, is not in the layout): the serving slot becomes the
+// slice's owner. Only the slice's own executor writes its entry and the next
+// dispatch reads it after the join.
+void shop::affinity_partitioner::record_owner( iterations_t const slice_begin ) noexcept
+{
+    auto const serving{ current_slot };
+    if ( serving.p_shop != p_shop_ || !number_of_slices_ ) // not a worker (of this shop) or not (yet) laid out
+        return;
+    auto const slice{ std::upper_bound( &slice_begin_[ 0 ], &slice_begin_[ number_of_slices_ ], slice_begin ) - &slice_begin_[ 0 ] };
+    if ( ( slice == 0 ) || ( slice_begin_[ slice - 1 ] != slice_begin ) ) // (a fallback, non sticky dispatch)
+        return;
+    slice_owner_[ slice - 1 ] = serving.slot;
+}
+#else
+void shop::affinity_partitioner::record_owner( iterations_t ) noexcept {}
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
+
 BOOST_NOINLINE
+// An async spread (p_async_barrier != nullptr) is dispatched like any other
+// (minus the caller's part) but not joined: the chunks arrive at the given
+// barrier and the last one to do so completes the spread (see
+// spread_async()). It always takes the shared queue path: that one expects
+// all of its arrivals up front while the direct worker dispatch counts them
+// in incrementally (as it goes) - a transient zero there would complete an
+// async spread early.
 bool shop::spread_work
 (
     spread_work_template_t       work_part_template,
     iterations_t           const iterations,
-    iterations_t                 parallelizable_iterations_count
+    iterations_t                 parallelizable_iterations_count,
+    thrd_lite::barrier   * const p_async_barrier /*= nullptr*/,
+    affinity_partitioner * const p_partitioner   /*= nullptr*/
 ) noexcept
 {
     if ( PSI_UNLIKELY( iterations == 0 ) ) [[ unlikely ]]
@@ -624,10 +1690,21 @@ bool shop::spread_work
 
     events::spread_begin( iterations );
 
-    thrd_lite::barrier completion_barrier;
+    auto const         async{ p_async_barrier != nullptr };
+    thrd_lite::barrier join_barrier;
+    auto & completion_barrier{ async ? *p_async_barrier : join_barrier };
     work_part_template.target_as<spread_work_base>().p_completion_barrier = &completion_barrier;
 
-    auto const items_in_shop{ number_of_items() };
+    // Without worker threads (threads = 1 or a single CPU) nobody would ever
+    // pick up an async spread (the caller takes no part in it) - perform it
+    // (and thus complete it) right away.
+    if ( PSI_UNLIKELY( async && number_of_worker_threads() == 0 ) ) [[ unlikely ]]
+    {
+        perform_caller_work( iterations, work_part_template, completion_barrier );
+        return true;
+    }
+
+    auto const items_in_shop{ number_of_items( /*spread_only:*/ true ) }; // (a fire backlog does not take the workers from spreads - see work_kind)
     if ( PSI_UNLIKELY( items_in_shop ) ) [[ unlikely ]]
     {
         events::spread_preexisting_work( items_in_shop );
@@ -659,20 +1736,43 @@ bool shop::spread_work
         }
     }
 
-#if !PSI_SWEATER_USE_PARALLELIZATION_COST
+#if PSI_SWEATER_USE_PARALLELIZATION_COST
+    parallelizable_iterations_count = std::max( parallelizable_iterations_count, options_.min_parallel_grain );
+#else
     parallelizable_iterations_count = 1;
 #endif // PSI_SWEATER_USE_PARALLELIZATION_COST
 
-    auto const actual_number_of_workers{ number_of_workers() };
+#if PSI_SWEATER_TRACK_CPU_LIMITS
+    // With no active workers (a quota of a single CPU) no worker goes idle
+    // to poll the limits - the caller has to.
+    if ( PSI_UNLIKELY( !active_worker_threads() ) ) [[ unlikely ]]
+        check_cpu_limits();
+#endif // PSI_SWEATER_TRACK_CPU_LIMITS
+    auto const actual_number_of_workers{ number_of_active_workers() };
     auto const free_workers            { static_cast<hardware_concurrency_t>( std::max<int>( 0, actual_number_of_workers - items_in_shop ) ) };
-    auto const max_work_parts          { free_workers ? free_workers : number_of_worker_threads() }; // prefer using any available worker - otherwise queue and wait
+    auto const max_work_parts          { free_workers ? free_workers : std::max<hardware_concurrency_t>( active_worker_threads(), 1 ) }; // prefer using any available worker - otherwise queue and wait
     auto const queue_and_wait          { !free_workers };
-    auto const use_caller_thread       { PSI_SWEATER_USE_CALLER_THREAD && !queue_and_wait };
+    auto const use_caller_thread       { PSI_SWEATER_USE_CALLER_THREAD && !queue_and_wait && !async };
 
 #if PSI_SWEATER_USE_CALLER_THREAD
-    completion_barrier.use_spin_wait( !queue_and_wait );
+    // The caller either spin-waits for the join (the barrier skips the wake
+    // syscalls) or, with options::adaptive_spin and a history of long joins,
+    // parks.
+#   if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+    auto const caller_spins{ !queue_and_wait && ( !options_.adaptive_spin || caller_idle_history_.spin() ) };
+#   else
+    auto const caller_spins{ !queue_and_wait };
+#   endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+    completion_barrier.use_spin_wait( caller_spins || async ); // (an async spread has no waiter to wake)
 #endif // PSI_SWEATER_USE_CALLER_THREAD
 
+    // Saturated (queue_and_wait): the slices get queued through a producer
+    // token of their own so that the caller can pick them out (ahead of the
+    // backlog) and run them itself instead of parking (see the join below).
+    std::optional<my_queue::producer_token_t> own_slices;
+    if ( queue_and_wait && !async )
+        own_slices.emplace( spread_queue_.producer_token() );
+
     hardware_concurrency_t dispatched_parts;
     bool enqueue_succeeded;
 #if PSI_SWEATER_HMP
@@ -681,69 +1781,39 @@ bool shop::spread_work
     // HMP logic (because the logic itself would need tweaking and
     // additional tracking of which cluster cores/workers are actually
     // free).
-    if ( hmp && !items_in_shop )
+    // (Sticky spreads keep to the uniform partitioning their partitioner
+    // remembers.)
+    if ( hmp_ && !items_in_shop && !async && !p_partitioner && ( hmp_clusters_.number_of_cores == actual_number_of_workers ) )
     {
-        BOOST_ASSERT_MSG( hmp_clusters.number_of_clusters, "HMP not configured" );
-        BOOST_ASSUME( hmp_clusters.number_of_clusters <= hmp_clusters.max_clusters );
+        BOOST_ASSERT_MSG( hmp_clusters_.number_of_clusters, "HMP not configured" );
+        BOOST_ASSUME( hmp_clusters_.number_of_clusters <= hmp_clusters_.max_clusters );
         BOOST_ASSUME( !thrd_lite::slow_thread_signals );
 
-        // Leftovers of the original (pre-work-stealing/pre-July 2021) HMP
-        // logic which 'cooperate good enough' with the work-stealing logic
-        // performed in/by dispatch_workers(). TODO: revisit this for a new
-        // approach tailored around work-stealing.
-
-        std::uint8_t number_used_of_clusters{ 0 };
-        iterations_t hmp_distributions[ hmp_clusters.max_clusters ];
-        {
-            iterations_t iteration{ 0 };
-            for ( auto cluster{ 0 }; cluster < hmp_clusters.number_of_clusters; ++cluster )
-            {
-                auto const cluster_power              { hmp_clusters.power[ cluster ] };
-                auto const cluster_cores              { hmp_clusters.cores[ cluster ] };
-                auto const weight_factor              { hmp_clusters.max_power        };
-                auto const weighted_cluster_iterations{ iterations * cluster_power / weight_factor };
-                auto const remaining_iterations       { static_cast<iterations_t>( iterations - iteration ) };
-                auto const cluster_iterations
-                {
-                    std::min
-                    (
-                        remaining_iterations,
-                        std::max<iterations_t>
-                        (
-                            weighted_cluster_iterations,
-                            // this also makes sure we use all cores of this cluster
-                            // before moving to the next one (i.e. even if
-                            // parallelizable_iterations_count == 1)
-                            parallelizable_iterations_count * cluster_cores
-                        )
-                    )
-                };
-                if ( PSI_UNLIKELY( !cluster_iterations ) ) // handle small spreads (w/ iterations < number of cores)
-                    break;
-                hmp_distributions[ cluster ]  = cluster_iterations;
-                iteration                    += cluster_iterations;
-                ++number_used_of_clusters;
-            }
-            BOOST_ASSUME( iteration <= iterations );
-            BOOST_ASSUME( ( number_used_of_clusters > 0 ) && ( number_used_of_clusters <= hmp_clusters.max_clusters ) );
-            auto const remaining_iterations{ iterations - iteration };
-            BOOST_ASSERT( remaining_iterations < hmp_distributions[ number_used_of_clusters - 1 ] );
-            hmp_distributions[ 0 ] += remaining_iterations; // add to strongest cluster
-        }
+        // Capacity-weighted partitioning (see hmp_partition()):
+        // dispatch_workers() then slices every core's part for stealing
+        // which absorbs whatever imbalance the static capacity estimates
+        // leave (frequency/thermal throttling, foreign load, memory bound
+        // kernels that do not scale with core capacity).
+        auto const parallelizable_parts{ std::max<iterations_t>( 1, iterations / parallelizable_iterations_count ) };
+        hmp_share  shares[ hmp_clusters_.max_clusters ];
+        auto const number_used_of_clusters{ hmp_partition( hmp_clusters_, iterations, static_cast<hardware_concurrency_t>( std::min<iterations_t>( parallelizable_parts, actual_number_of_workers ) ), shares ) };
+        BOOST_ASSUME( ( number_used_of_clusters > 0 ) && ( number_used_of_clusters <= hmp_clusters_.max_clusters ) );
 
         iterations_t           caller_thread_end_iteration{ 0 };
         iterations_t           iteration                  { 0 };
         hardware_concurrency_t worker                     { 0 };
         for ( auto cluster{ 0 }; cluster < number_used_of_clusters; ++cluster )
         {
-            auto const cluster_iterations        { hmp_distributions [ cluster ]      };
-            auto       cluster_cores             { hmp_clusters.cores[ cluster ]      };
-            auto       per_core_iterations       { cluster_iterations / cluster_cores };
-            auto       parts_with_extra_iteration{ cluster_iterations % cluster_cores };
+            auto const & share{ shares[ cluster ] };
+            BOOST_ASSUME( share.begin == iteration );
+            auto       cluster_cores             { share.parts };
+            auto const cluster_iterations        { static_cast<iterations_t>( share.end - share.begin ) };
+            auto const per_core_iterations       { cluster_cores ? cluster_iterations / cluster_cores : 0 };
+            auto       parts_with_extra_iteration{ cluster_cores ? cluster_iterations % cluster_cores : 0 };
 
             if ( use_caller_thread && ( cluster == 0 ) )
             {
-                BOOST_ASSUME( iteration == 0 );
+                BOOST_ASSUME( cluster_cores > 0 ); // the strongest cores get at least iterations / parts each
                 auto const extra_iteration{ parts_with_extra_iteration != 0 };
                 caller_thread_end_iteration  = per_core_iterations + extra_iteration;
                 iteration = caller_thread_end_iteration;
@@ -751,8 +1821,11 @@ bool shop::spread_work
                 parts_with_extra_iteration -= extra_iteration;
             }
 
-            std::tie( worker, iteration ) = dispatch_workers( worker, iteration, cluster_cores, per_core_iterations, parts_with_extra_iteration, iterations, completion_barrier, work_part_template );
+            if ( cluster_cores )
+                worker = dispatch_workers( share.first_worker, iteration, cluster_cores, per_core_iterations, parts_with_extra_iteration, share.end, completion_barrier, work_part_template ).first;
+            iteration = share.end;
         }
+        BOOST_ASSUME( iteration == iterations );
         enqueue_succeeded = true; //...mrmlj...
 
         if ( PSI_LIKELY( use_caller_thread ) ) [[ likely ]]
@@ -762,7 +1835,7 @@ bool shop::spread_work
 
         dispatched_parts = worker;
     }
-    else // !HMP || items_in_shop
+    else // !HMP || items_in_shop || resized pool
 #endif // PSI_SWEATER_HMP
     {
         auto parallelizable_parts           { std::max<iterations_t>( 1, iterations / parallelizable_iterations_count ) };
@@ -789,9 +1862,12 @@ bool shop::spread_work
 #   if PSI_SWEATER_EXACT_WORKER_SELECTION
         // When there are items_in_shop fallback to the shared queue (as
         // there is currently no tracking which queues/workers are taken).
-        if ( !thrd_lite::slow_thread_signals && !items_in_shop ) [[ likely ]]
+        if ( !thrd_lite::slow_thread_signals && !items_in_shop && !async ) [[ likely ]]
         {
-            iteration = dispatch_workers( 0, iteration, number_of_dispatched_work_parts, iterations_per_part, parts_with_extra_iteration, iterations, completion_barrier, work_part_template ).second;
+            if ( p_partitioner && number_of_dispatched_work_parts )
+                iteration = dispatch_sticky( *p_partitioner, iteration, number_of_dispatched_work_parts, iterations_per_part, parts_with_extra_iteration, iterations, completion_barrier, work_part_template );
+            else
+                iteration = dispatch_workers( 0, iteration, number_of_dispatched_work_parts, iterations_per_part, parts_with_extra_iteration, iterations, completion_barrier, work_part_template ).second;
             BOOST_ASSUME( iteration <= iterations );
             enqueue_succeeded = true; //...mrmlj...
         }
@@ -804,8 +1880,8 @@ bool shop::spread_work
                 // Slice up the parts for work stealing (unless there are other
                 // active spreads - there's work to steal so don't create
                 // unnecessary queue traffic).
-                auto const stealing_division{ spread_work_stealing_division.load( std::memory_order_relaxed ) };
-                BOOST_ASSUME( stealing_division <= spread_work_stealing_division_max );
+                auto const stealing_division{ stealing_division_.load( std::memory_order_relaxed ) };
+                BOOST_ASSUME( stealing_division <= options::stealing_division_limit );
                 BOOST_ASSUME( iteration + iterations_per_part * number_of_dispatched_work_parts + parts_with_extra_iteration == iterations );
                 auto const slice_div
                 {
@@ -859,11 +1935,9 @@ bool shop::spread_work
             // this thread could enter the if ( enqueue_succeeded ) block and initialize the
             // the barrier there).
             completion_barrier.initialize( number_of_dispatched_work_parts );
-            enqueue_succeeded = queue_.enqueue_bulk
-            (
-                std::make_move_iterator( dispatched_work_parts ),
-                number_of_dispatched_work_parts
-            );
+            enqueue_succeeded = ( own_slices && own_slices->valid() )
+                ? spread_queue_.enqueue_bulk( *own_slices, std::make_move_iterator( dispatched_work_parts ), number_of_dispatched_work_parts )
+                : spread_queue_.enqueue_bulk(              std::make_move_iterator( dispatched_work_parts ), number_of_dispatched_work_parts );
             events::worker_bulk_enqueue_end();
             if ( PSI_LIKELY( enqueue_succeeded ) )
             {
@@ -906,22 +1980,27 @@ bool shop::spread_work
         dispatched_parts = number_of_dispatched_work_parts;
     } // !HMP
 
+    if ( async )
+    {
+        events::spread_end( dispatched_parts, use_caller_thread );
+        return enqueue_succeeded;
+    }
+
     // Caller work stealing
-    if ( !queue_and_wait && !queue_.empty() )
+    if ( !queue_and_wait && !spread_queue_.empty() )
     {
         events::caller_stolen_work_begin();
         work_t work;
         std::uint32_t stolen_items{ 0 };
         while ( true )
         {
-            {
-                // Support concurrent spreads (tokens aren't thread-safe).
-                std::scoped_lock<thrd_lite::spin_lock> const token_lock{ consumer_token_mutex_ };
-                if ( !queue_.dequeue( work, consumer_token_ ) )
-                    break;
-            }
+            // (Tokens aren't thread-safe: one per caller thread for concurrent
+            // spreads - fetched anew for every dequeue as work() may, through
+            // nested spreads on other shops, evict this shop's cached one.)
+            if ( !spread_queue_.dequeue( work, caller_consumer_token() ) )
+                break;
             work();
-            work_completed();
+            work_completed( work_kind::spread );
             ++stolen_items;
         }
         events::caller_stolen_work_end( stolen_items );
@@ -930,20 +2009,30 @@ bool shop::spread_work
 #if PSI_SWEATER_USE_CALLER_THREAD
     if ( !queue_and_wait )
     {
+#   if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+        auto const join_begin{ options_.adaptive_spin ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{} };
+#   endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
         if ( !completion_barrier.everyone_arrived() )
         {
             // Increase work-splitting if the worker has to wait/stall (having no work to steal).
             BOOST_ASSUME( dispatched_parts );
             events::caller_join_begin( use_caller_thread );
-            auto const stalled
+            // (only a spinning join measures a stall: a parked one, chosen by
+            // the adaptive spin for long gaps, says nothing about the split)
+            auto stalled{ false };
+            if ( caller_spins )
             {
-                completion_barrier.spin_wait
+                stalled = completion_barrier.spin_wait
                 (
 #               if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
-                    caller_spin_count
+                    options_.caller_spin_count
 #               endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
-                )
-            };
+                );
+            }
+            else
+            {
+                completion_barrier.wait();
+            }
             events::caller_join_end();
             if ( stalled )
             {
@@ -952,18 +2041,41 @@ bool shop::spread_work
                 // store) so a concurrently-advanced value is never regressed;
                 // on CAS failure someone else already bumped it -- good enough,
                 // no retry needed for a monotone heuristic.
-                auto current{ spread_work_stealing_division.load( std::memory_order_relaxed ) };
+                auto current{ stealing_division_.load( std::memory_order_relaxed ) };
                 events::caller_stalled( current );
-                if ( current < spread_work_stealing_division_max )
+                if ( current < options_.stealing_division_max )
                 {
-                    spread_work_stealing_division.compare_exchange_strong( current, static_cast<std::uint8_t>( current + 1 ), std::memory_order_relaxed, std::memory_order_relaxed );
+                    stealing_division_.compare_exchange_strong( current, static_cast<std::uint8_t>( current + 1 ), std::memory_order_relaxed, std::memory_order_relaxed );
                 }
             }
         }
+#   if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+        if ( options_.adaptive_spin )
+            caller_idle_history_.record( nanoseconds_since( join_begin ), options_.caller_spin_count );
+#   endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
     }
     else
 #endif // PSI_SWEATER_USE_CALLER_THREAD
     {
+        // Rather than parking behind the backlog the caller runs slices until
+        // the join completes - its own first, then anyone's (fire items are
+        // left to the workers: unlike slices they are not bounded in size).
+        if ( !completion_barrier.everyone_arrived() )
+        {
+            events::caller_stolen_work_begin();
+            work_t work;
+            std::uint32_t stolen_items{ 0 };
+            while ( !completion_barrier.everyone_arrived() )
+            {
+                auto const own_slice{ own_slices && own_slices->valid() && spread_queue_.dequeue_from_producer( work, *own_slices ) };
+                if ( !own_slice && !spread_queue_.dequeue( work, caller_consumer_token() ) )
+                    break;
+                work();
+                work_completed( work_kind::spread );
+                ++stolen_items;
+            }
+            events::caller_stolen_work_end( stolen_items );
+        }
         events::caller_join_begin( use_caller_thread );
         completion_barrier.wait();
         events::caller_join_end();
@@ -973,14 +2085,226 @@ bool shop::spread_work
     return enqueue_succeeded;
 }
 
+bool shop::spread_many( std::initializer_list<loop> const loops, iterations_t const parallelizable_iterations_count ) noexcept
+{
+    struct fused_spread_wrapper : spread_work_base
+    {
+        void operator()() noexcept
+        {
+            BOOST_ASSUME( start_iteration < end_iteration );
+            // (a handful of loops: a linear walk to the chunk's first one)
+            iterations_t loop_begin{ 0 };
+            for ( auto const & each_loop : *static_cast<std::initializer_list<shop::loop> const *>( p_work ) )
+            {
+                if ( !each_loop.iterations() ) // (never call a body with an empty range)
+                    continue;
+                auto const loop_end{ static_cast<iterations_t>( loop_begin + each_loop.iterations() ) };
+                if ( start_iteration < loop_end )
+                {
+                    each_loop( std::max( start_iteration, loop_begin ) - loop_begin, std::min( end_iteration, loop_end ) - loop_begin );
+                    if ( end_iteration <= loop_end )
+                        break;
+                }
+                loop_begin = loop_end;
+            }
+            p_completion_barrier->arrive();
+        }
+    }; // struct fused_spread_wrapper
+    static_assert( std::is_standard_layout_v<fused_spread_wrapper> ); // required for correctness of work_t::target_as() usage
+
+    std::uint64_t total_iterations{ 0 };
+    for ( auto const & each_loop : loops )
+        total_iterations += each_loop.iterations();
+    // The concatenated iteration space does not fit a single spread: fall
+    // back to a spread per loop.
+    if ( PSI_UNLIKELY( total_iterations > std::numeric_limits<iterations_t>::max() ) ) [[ unlikely ]]
+    {
+        bool all_enqueued{ true };
+        for ( auto const & each_loop : loops )
+            all_enqueued &= spread_the_sweat( each_loop.iterations(), each_loop, parallelizable_iterations_count );
+        return all_enqueued;
+    }
+
+#ifdef BOOST_GCC
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif // GCC
+    return spread_work( fused_spread_wrapper{{ .p_work = &loops }}, static_cast<iterations_t>( total_iterations ), parallelizable_iterations_count );
+#ifdef BOOST_GCC
+#   pragma GCC diagnostic pop
+#endif // GCC
+}
+
+bool shop::spread_chain( iterations_t const iterations, std::initializer_list<stage> const stages, iterations_t const parallelizable_iterations_count ) noexcept
+{
+    struct chained_spread_wrapper : spread_work_base
+    {
+        void operator()() noexcept
+        {
+            BOOST_ASSUME( start_iteration < end_iteration );
+            for ( auto const & each_stage : *static_cast<std::initializer_list<shop::stage> const *>( p_work ) )
+                each_stage( start_iteration, end_iteration );
+            p_completion_barrier->arrive();
+        }
+    }; // struct chained_spread_wrapper
+    static_assert( std::is_standard_layout_v<chained_spread_wrapper> ); // required for correctness of work_t::target_as() usage
+
+#ifdef BOOST_GCC
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif // GCC
+    return spread_work( chained_spread_wrapper{{ .p_work = &stages }}, iterations, parallelizable_iterations_count );
+#ifdef BOOST_GCC
+#   pragma GCC diagnostic pop
+#endif // GCC
+}
+
+shop::region::region( hardware_concurrency_t const participants, std::uint32_t const spin_count, body_t * const body, void const * const p_work ) noexcept
+    : barrier_{ participants }, spin_count_{ spin_count }, body_{ body }, p_work_{ p_work } {}
+
+// The phase cannot move on before this participant's sync() (which ends
+// every single()) so the only claim another participant can have made in it
+// is this same one.
+bool shop::region::claim_single() noexcept
+{
+    auto const claim  { barrier_.phase() + 1 };
+    auto       claimed{ last_single_.load( std::memory_order_relaxed ) };
+    return ( claimed != claim ) && last_single_.compare_exchange_strong( claimed, claim, std::memory_order_relaxed, std::memory_order_relaxed );
+}
+
+// The team is made of the workers that are idle right now. Its members are
+// not queued items: any thread taking queued slices while it already is a
+// participant (e.g. the join of a spread issued from within the region)
+// could take a member too and wait for itself in sync(). The region is
+// instead opened for a number of members that only workers (and spares),
+// between items, join (see join_open_region()): with exact worker selection
+// the idle ones are popped off the idle stack (see push_idle()) and
+// signalled, otherwise as many workers as the items in the shop leave free
+// get woken. Members stay in the region until work returns - they block in
+// region::sync() so none of them ever joins twice. A team counts on all of
+// its members running at once: a member joined late by a busy worker (a
+// long fire item, a participant of another region or the item that called
+// parallel_region()) would stall the whole team - hence nested, concurrent
+// and item-issued regions (spares standing in for blocked workers included)
+// get a team of just the caller.
+void shop::parallel_region_work( region::body_t * const body, void const * const p_work ) noexcept
+{
+#if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+    auto const spin_count{ options_.worker_spin_count };
+#else
+    auto const spin_count{ 0U };
+#endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+    region team{ 1, spin_count, body, p_work };
+
+    hardware_concurrency_t members{ 0 };
+    if ( !region_active_.exchange( true, std::memory_order_acquire ) )
+    {
+        auto const this_thread{ thrd_lite::thread::get_active_thread_id() };
+#   if PSI_SWEATER_HAS_BLOCKING_REGION
+        auto issued_by_item{ current_slot.p_shop == this };
+#   else
+        auto issued_by_item{ false };
+#   endif // PSI_SWEATER_HAS_BLOCKING_REGION
+        for ( auto const & worker : pool_ )
+            issued_by_item |= ( worker.get_id() == this_thread );
+        auto const max_members{ issued_by_item ? hardware_concurrency_t{ 0 } : active_worker_threads() };
+        if ( max_members )
+        {
+            auto const open{ [ & ]() noexcept
+            {
+                team.barrier_     .initialize( static_cast<hardware_concurrency_t>( members + 1 ) );
+                team.members_done_.initialize( members );
+                work_added_untracked( members ); // (members take workers from spreads)
+                open_region_    .store( &team  , std::memory_order_relaxed );
+                region_openings_.store( members, std::memory_order_release );
+            } };
+#       if PSI_SWEATER_EXACT_WORKER_SELECTION
+            if ( !thrd_lite::slow_thread_signals ) [[ likely ]]
+            {
+#           ifdef BOOST_MSVC
+                auto const member_workers{ static_cast<worker_thread * *>( alloca( max_members * sizeof( worker_thread * ) ) ) };
+#           else
+                worker_thread * member_workers[ max_members ];
+#           endif // BOOST_MSVC
+                while ( members < max_members )
+                {
+                    auto * const p_idle{ pop_idle() };
+                    if ( !p_idle )
+                        break;
+                    member_workers[ members++ ] = p_idle;
+                }
+                if ( members )
+                {
+                    open();
+                    for ( hardware_concurrency_t member{ 0 }; member < members; ++member )
+                        member_workers[ member ]->notify();
+                }
+            }
+            else
+#       endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+            {
+                members = static_cast<hardware_concurrency_t>( std::max<int>( 0, max_members - number_of_items() ) ); // (fire items take workers too)
+                if ( members )
+                {
+                    open();
+#               if !PSI_SWEATER_EXACT_WORKER_SELECTION || defined( __ANDROID__ ) // Android also has the fallback work_semaphore_ for slow_thread_signals devices
+                    if ( thrd_lite::slow_thread_signals )
+                        work_semaphore_.signal( members );
+                    else
+#               endif
+                        wake_all_workers();
+                }
+            }
+        }
+        if ( !members )
+            region_active_.store( false, std::memory_order_release );
+    }
+
+    team.run( 0 );
+
+    if ( members )
+    {
+        team.members_done_.wait();
+        region_active_.store( false, std::memory_order_release );
+    }
+}
+
+bool shop::join_open_region() noexcept
+{
+    auto openings{ region_openings_.load( std::memory_order_acquire ) };
+    while ( openings ) // (no region being staffed: a single load)
+    {
+        if ( !region_openings_.compare_exchange_weak( openings, static_cast<hardware_concurrency_t>( openings - 1 ), std::memory_order_acquire, std::memory_order_acquire ) )
+            continue;
+        auto & team{ *open_region_.load( std::memory_order_relaxed ) };
+        team.run( team.next_member_.fetch_add( 1, std::memory_order_relaxed ) );
+        work_completed( work_kind::spread );
+        team.members_done_.arrive(); // (the last touch of the team: the caller may return)
+        return true;
+    }
+    return false;
+}
 
 void shop::wake_all_workers() noexcept
 {
 #if PSI_SWEATER_EXACT_WORKER_SELECTION
     if ( !thrd_lite::slow_thread_signals )
     {
+#   if PSI_SWEATER_EVENTCOUNT_PARKING
+        // A token for every worker but a single wake syscall for all of the
+        // parked ones: they also park on the idle_workers_ eventcount's epoch
+        // - instead of a FUTEX_WAKE per worker on the caller's critical path
+        // (without eventcount parking signal_deferred() wakes each sleeper
+        // itself and returns false).
+        bool any_asleep{ false };
+        for ( auto & worker : pool_ )
+            any_asleep |= worker.event_.signal_deferred();
+        if ( any_asleep )
+            idle_workers_.wake_all();
+#   else
         for ( auto & worker : pool_ )
             worker.notify();
+#   endif // PSI_SWEATER_EVENTCOUNT_PARKING
     }
     else
 #endif
@@ -996,20 +2320,76 @@ void shop::wake_all_workers() noexcept
 //...mrmlj...allowing underflow/overflow because of late fetch_add in fire_and_forget and concurrent invocation 'races'
 void shop::work_added    ( hardware_concurrency_t const items ) noexcept
 {
-    work_items_.fetch_add( items, std::memory_order_acquire );
+    work_item_shard().added_[ static_cast<std::uint8_t>( work_kind::fire ) ].fetch_add( items, std::memory_order_relaxed );
     if ( items ) { detail::in_flight_inc(); }
 }
 void shop::work_added_untracked( hardware_concurrency_t const items ) noexcept
 {
-    work_items_.fetch_add( items, std::memory_order_acquire );
+    work_item_shard().added_[ static_cast<std::uint8_t>( work_kind::spread ) ].fetch_add( items, std::memory_order_relaxed );
 }
-void shop::work_completed(                                    ) noexcept { /*thrd_lite::detail::underflow_checked_dec( work_items_        );*/ work_items_.fetch_sub( 1    , std::memory_order_release ); }
+void shop::work_completed( work_kind const kind, hardware_concurrency_t const items ) noexcept { work_item_shard().completed_[ static_cast<std::uint8_t>( kind ) ].fetch_add( items, std::memory_order_release ); }
 
 #if PSI_SWEATER_EXACT_WORKER_SELECTION
+bool shop::enqueue_fire( work_t && work ) noexcept
+{
+#if PSI_SWEATER_EVENTCOUNT_PARKING
+    if ( eventcount_parking_ ) [[ likely ]]
+    {
+        // The item goes to a producer token but the wake-up to whichever
+        // worker is idle (they all steal): a no-op (a fence and a load) while
+        // the whole pool is busy and at most one wake syscall otherwise -
+        // never a wake of a worker that is busy (or parked) while others
+        // idle, which the targeted guess of next_dispatch_target() cannot
+        // rule out.
+        auto const success{ next_dispatch_target().enqueue( std::move( work ), queue_, false ) };
+        if ( auto * const p_idle{ pop_idle() } )
+            p_idle->notify();
+        else
+            idle_workers_.notify_one(); // (workers on their way to push_idle())
+        return success;
+    }
+#endif // PSI_SWEATER_EVENTCOUNT_PARKING
+    if ( auto * const p_idle{ pop_idle() } )
+        return p_idle->enqueue( std::move( work ), queue_ );
+    return next_dispatch_target().enqueue( std::move( work ), queue_ );
+}
+
+// Idle workers are tracked in a lock-free LIFO (see thrd_lite::idle_stack)
+// so that the fire path wakes the most recently idled worker first: its
+// caches and TLB are still warm, it is likely still spinning (a syscall-free
+// signal) or at least not yet in a deep C-state - waking a long parked worker
+// measured 2-5x costlier. The workers at the bottom of the stack are
+// conversely the long idle ones that an elastic pool would retire.
+// Entries are not removed by workers woken through other means (the spread
+// wake tree, broadcasts): they leave() them and pop_idle() skips them.
+void shop::push_idle( hardware_concurrency_t const slot ) noexcept
+{
+    idle_stack_.push( slot, pool_[ slot ].idle_ );
+}
+
+shop::worker_thread * shop::pop_idle() noexcept
+{
+    auto const slot{ idle_stack_.pop( [ this ]( thrd_lite::idle_stack::index_t const index ) noexcept -> thrd_lite::idle_stack::entry & { return pool_[ index ].idle_; } ) };
+    return ( slot != thrd_lite::idle_stack::none ) ? &pool_[ slot ] : nullptr;
+}
+
 shop::worker_thread & shop::next_dispatch_target() noexcept
 {
-    auto const workers{ number_of_worker_threads() };
-    BOOST_ASSUME( workers > 0 );
+    BOOST_ASSUME( number_of_worker_threads() > 0 );
+    auto const workers{ std::max<hardware_concurrency_t>( active_worker_threads(), 1 ) };
+#if PSI_SWEATER_EVENTCOUNT_PARKING
+    if ( eventcount_parking_ ) [[ likely ]]
+    {
+        // Only a producer token to pick: the caller's own slot when firing
+        // from within the pool (its owner drains it first, with warm caches,
+        // and no other producer contends for the token lock) - otherwise
+        // plain round-robin (spreading the producer sublists for the
+        // stealing consumers).
+        if ( current_slot.p_shop == this )
+            return pool_[ current_slot.slot ];
+        return pool_[ static_cast<hardware_concurrency_t>( dispatch_rotor_.fetch_add( 1, std::memory_order_relaxed ) % workers ) ];
+    }
+#endif // PSI_SWEATER_EVENTCOUNT_PARKING
     // Depth-bounded sticky dispatch: stay on the current target while its
     // backlog is small, spill to the next worker only once it piles up. The
     // backlog proxy is the target's event semaphore's unconsumed-token count
@@ -1028,7 +2408,7 @@ shop::worker_thread & shop::next_dispatch_target() noexcept
     // where it matters (items long enough to overlap) and traded for syscall
     // elision only where it does not (items shorter than the dispatch cost).
     // The stealing dequeue path remains the backstop for any imbalance.
-    constexpr std::int32_t sticky_dispatch_depth{ 2 };
+    auto const sticky_dispatch_depth{ static_cast<std::int32_t>( options_.sticky_dispatch_depth ) };
     auto rotor { dispatch_rotor_.load( std::memory_order_relaxed ) };
     auto target{ &pool_[ static_cast<hardware_concurrency_t>( rotor % workers ) ] };
     if ( target->event_.pending() > sticky_dispatch_depth )
@@ -1041,27 +2421,60 @@ shop::worker_thread & shop::next_dispatch_target() noexcept
 
 void shop::worker_thread::notify() noexcept { event_.signal(); }
 
-bool shop::worker_thread::enqueue( work_t && __restrict work, my_queue & __restrict queue ) noexcept
+namespace
+{
+    // The lane a thread tries first (see worker_thread::on_free_lane()):
+    // handed out round-robin so that concurrent producers start off on
+    // different lanes (and a single producer keeps to one - preserving its
+    // FIFO order in the common case).
+    std::uint8_t producer_lane_hint() noexcept
+    {
+        static std::atomic<std::uint8_t> next_hint{ 0 };
+        thread_local auto const hint{ next_hint.fetch_add( 1, std::memory_order_relaxed ) };
+        return hint;
+    }
+} // anonymous namespace
+
+template <typename Enqueue>
+bool shop::worker_thread::on_free_lane( lanes_t & lanes, Enqueue && enqueue ) noexcept
 {
     BOOST_ASSUME( !thrd_lite::slow_thread_signals );
-    bool success;
+    auto const first_lane{ producer_lane_hint() };
+    for ( std::uint8_t attempt{ 0 }; attempt < producer_lanes; ++attempt )
+    {
+        auto & lane{ lanes[ ( first_lane + attempt ) % producer_lanes ] };
+        if ( lane.mutex_.try_lock() )
+        {
+            std::scoped_lock<thrd_lite::spin_lock> const lane_lock{ std::adopt_lock, lane.mutex_ };
+            return enqueue( *lane.token_ );
+        }
+    }
+    // Every lane taken (more concurrent producers than lanes): wait for ours.
+    auto & lane{ lanes[ first_lane % producer_lanes ] };
+    std::scoped_lock<thrd_lite::spin_lock> const lane_lock{ lane.mutex_ };
+    return enqueue( *lane.token_ );
+}
+
+bool shop::worker_thread::enqueue( work_t && __restrict work, my_queue & __restrict queue, bool const notify_worker /*= true*/ ) noexcept
+{
+    auto const success
+    {
+        on_free_lane( fire_lanes_, [ & ]( my_queue::producer_token_t & token ) noexcept { return queue.enqueue( std::move( work ), token ); } )
+    };
+    if ( notify_worker )
     {
-        std::scoped_lock<thrd_lite::spin_lock> const token_lock{ token_mutex_ };
-        success = queue.enqueue( std::move( work ), *token_ );
+        notify();
     }
-    notify();
     return success;
 }
 
 bool shop::worker_thread::enqueue( std::move_iterator< work_t * > const p_work, hardware_concurrency_t const number_of_items, my_queue & __restrict queue, bool const notify_worker /*= true*/ ) noexcept
 {
-    BOOST_ASSUME( !thrd_lite::slow_thread_signals );
-    BOOST_ASSERT( number_of_items                 );
-    bool success;
+    BOOST_ASSERT( number_of_items );
+    auto const success
     {
-        std::scoped_lock<thrd_lite::spin_lock> const token_lock{ token_mutex_ };
-        success = queue.enqueue_bulk( *token_, p_work, number_of_items );
-    }
+        on_free_lane( spread_lanes_, [ & ]( my_queue::producer_token_t & token ) noexcept { return queue.enqueue_bulk( token, p_work, number_of_items ); } )
+    };
     if ( notify_worker )
     {
         notify();
@@ -1069,25 +2482,76 @@ bool shop::worker_thread::enqueue( std::move_iterator< work_t * > const p_work,
     return success;
 }
 
-// Spread wake propagation: a worker woken with (spread) work still in
-// flight wakes its two children in the binary wake tree over ABSOLUTE
-// worker indices, rooted at worker 0 (children of i are 2i+1 / 2i+2 --
-// which matches the dispatch origin, since the non-HMP dispatch path
-// always starts handing out slices at worker 0). This gives log2(N) wake
-// depth without the caller serially paying one wake syscall per worker on
-// its critical path (the measured dominant term of small-spread joins: one
-// syscall per worker, ~1-4 us each). The caller wakes only the tree root;
-// propagation is a heuristic best-effort -- a chain that skips a worker
-// (HMP dispatch starting mid-pool, a worker draining the queue early)
-// simply means the remaining work is done by the already-awake threads and
-// the (always-participating, work-stealing) caller.
+bool shop::worker_thread::dequeue( work_t & work, my_queue & __restrict queue, lanes_t & lanes ) noexcept
+{
+    for ( auto & lane : lanes )
+    {
+        if ( queue.dequeue_from_producer( work, *lane.token_ ) )
+            return true;
+    }
+    return false;
+}
+
+// Spread wake propagation: the caller wakes only the first worker of a
+// dispatch run (the wake tree root) and the woken workers wake the rest -- a
+// wake tree of log_arity(N) depth instead of the caller serially paying a
+// wake syscall per worker on its critical path (the measured dominant term of
+// small-spread joins: ~1-4 us each).
+// The tree is a pre-order k-ary one (options::wake_tree_arity) over exactly
+// the workers the run gave slices to: a worker's subtree is the contiguous
+// range [itself, wake_subtree_end_) and the rest of it is split into (up to)
+// arity contiguous child subtrees. As workers are ordered by locality (with
+// PSI_SWEATER_TOPOLOGY), contiguous subtrees stay within cache domains and the
+// NUMA nodes get split off first (one child per further node) so that each
+// node wakes its own workers. Concurrent spreads targeting the same worker
+// merge their subtrees (the larger end wins: both start at the worker).
+// Propagation remains a best-effort heuristic: anything it misses is done by
+// the already-awake threads and the (always-participating, work-stealing)
+// caller.
 void shop::propagate_spread_wake( hardware_concurrency_t const worker_index ) noexcept
 {
-    auto const workers{ number_of_worker_threads() };
-    auto const left   { static_cast<hardware_concurrency_t>( 2 * worker_index + 1 ) };
-    auto const right  { static_cast<hardware_concurrency_t>( 2 * worker_index + 2 ) };
-    if ( left  < workers ) { pool_[ left  ].notify(); }
-    if ( right < workers ) { pool_[ right ].notify(); }
+    auto & worker{ pool_[ worker_index ] };
+    if ( worker.wake_subtree_end_.load( std::memory_order_relaxed ) == 0 ) [[ likely ]]
+        return;
+    auto end{ worker.wake_subtree_end_.exchange( 0, std::memory_order_relaxed ) };
+    BOOST_ASSUME( end <= pool_.size() );
+    // Keyed off the shop-wide item counter (which never yields a false
+    // negative, unlike the queue's own view - see worker_loop): nothing left
+    // to wake anyone for.
+    if ( number_of_items( /*spread_only:*/ true ) == 0 )
+        return;
+    auto first{ static_cast<hardware_concurrency_t>( worker_index + 1 ) };
+#if PSI_SWEATER_TOPOLOGY
+    if ( ( worker.node_end_ >= first ) && ( worker.node_end_ < end ) )
+    {
+        for ( auto node_begin{ worker.node_end_ }; node_begin < end; )
+        {
+            auto const node_end{ static_cast<hardware_concurrency_t>( std::clamp( pool_[ node_begin ].node_end_, static_cast<hardware_concurrency_t>( node_begin + 1 ), end ) ) };
+            wake_spread_subtree( node_begin, node_end );
+            node_begin = node_end;
+        }
+        end = worker.node_end_;
+    }
+#endif // PSI_SWEATER_TOPOLOGY
+    auto const size    { static_cast<unsigned>( std::max( end, first ) - first ) };
+    auto const children{ std::min<unsigned>( std::max<unsigned>( options_.wake_tree_arity, 1 ), size ) };
+    for ( auto child{ 0U }; child < children; ++child )
+    {
+        wake_spread_subtree
+        (
+            static_cast<hardware_concurrency_t>( first + size *   child       / children ),
+            static_cast<hardware_concurrency_t>( first + size * ( child + 1 ) / children )
+        );
+    }
+}
+
+void shop::wake_spread_subtree( hardware_concurrency_t const first, hardware_concurrency_t const end ) noexcept
+{
+    BOOST_ASSUME( first < end );
+    auto & root{ pool_[ first ] };
+    auto   pending_end{ root.wake_subtree_end_.load( std::memory_order_relaxed ) };
+    while ( ( pending_end < end ) && !root.wake_subtree_end_.compare_exchange_weak( pending_end, end, std::memory_order_relaxed ) ) {}
+    root.notify(); // (release: publishes the subtree to the woken worker)
 }
 #endif // PSI_SWEATER_EXACT_WORKER_SELECTION
 
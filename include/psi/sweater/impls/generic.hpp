@@ -25,9 +25,15 @@
 #include "../threading/outcome_future.hpp"
 #endif
 #include "../threading/hardware_concurrency.hpp"
+#include "../threading/idle_stack.hpp"
 #include "../threading/cpp/spin_lock.hpp"
+#include "../threading/eventcount.hpp"
+#include "../threading/phase_barrier.hpp"
 #include "../threading/semaphore.hpp"
 #include "../threading/thread.hpp"
+#if PSI_SWEATER_TOPOLOGY
+#include "../threading/topology.hpp"
+#endif // PSI_SWEATER_TOPOLOGY
 
 #include <boost/core/no_exceptions_support.hpp>
 #include <boost/config_ex.hpp>
@@ -36,20 +42,24 @@
 #endif // PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
 #include <psi/functionoid/functionoid.hpp>
 
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <initializer_list>
 #include <future>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <new>
 #if PSI_SWEATER_EXACT_WORKER_SELECTION
 #include <optional>
 #endif
 #if !PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
 #include <span>
 #endif // !PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
+#include <string>
 #include <type_traits>
 #if 0 // sacrifice standard conformance to avoid the overhead of system_error
 #include <system_error>
@@ -63,6 +73,22 @@
 // thread pool) do not define this — callers must do per-task init there.
 #define PSI_SWEATER_HAS_WORKER_INIT_HOOK 1
 
+// Compensating spare threads for workers that block (shop::blocking_region):
+// spares stand in for a worker's exact-selection slot (its producer token and
+// wake event) so the feature exists only with PSI_SWEATER_EXACT_WORKER_SELECTION.
+#define PSI_SWEATER_HAS_BLOCKING_REGION PSI_SWEATER_EXACT_WORKER_SELECTION
+
+// Per-instance tuning and placement (shop::options) - see the struct.
+#define PSI_SWEATER_HAS_SHOP_OPTIONS 1
+
+// Idle workers park on a shop-wide eventcount (next to their own wake event)
+// so that fire_and_forget items wake ANY idle worker instead of a guessed
+// one (see shop::enqueue_fire()) and a whole-pool wake-up (see shop::
+// wake_all_workers()) takes a single wake syscall. Needs futexes (the
+// eventcount's epoch) - whether the platform can actually park on both words
+// at once is a runtime matter (thrd_lite::semaphore::supports_broadcast()).
+#define PSI_SWEATER_EVENTCOUNT_PARKING ( PSI_SWEATER_EXACT_WORKER_SELECTION && PSI_THRD_LITE_HAS_FUTEX )
+
 //------------------------------------------------------------------------------
 namespace psi::sweater::queues { template <typename Work> class mpmc_moodycamel; }
 //------------------------------------------------------------------------------
@@ -78,8 +104,6 @@ public:
     using iterations_t = std::uint32_t;
 
 #if PSI_SWEATER_HMP
-    static bool hmp;
-
     struct hmp_clusters_info
     {
         static auto constexpr max_clusters{ 3 }; // big - medium - little / turbo - big - little (Android state of affairs)
@@ -88,34 +112,52 @@ public:
         float                  power[ max_clusters ]; // 'capacity' as in capacity aware scheduling
     }; // struct hmp_clusters_info
 
-private:
+    // The form of a configure_hmp() configuration spreads work with.
     struct hmp_config
     {
         static auto constexpr max_clusters{ hmp_clusters_info::max_clusters };
-        static auto constexpr max_power   { 128 };
+        static auto constexpr max_weight  { 1024 };
 
-        hardware_concurrency_t cores[ max_clusters ];
-        std::uint8_t           power[ max_clusters ]; // 'capacity' as in capacity aware scheduling
+        hardware_concurrency_t cores      [ max_clusters ];
+        std::uint16_t          core_weight[ max_clusters ]; // per-core share of the cluster's power (the strongest core's = max_weight)
 
-        std::uint8_t number_of_clusters;
+        std::uint8_t           number_of_clusters;
+        hardware_concurrency_t number_of_cores; // the pool (+caller) size the configuration was made for
     }; // struct hmp_config
 
-    static hmp_config hmp_clusters;
-
-public:
-#else
-    static bool constexpr hmp{ false };
-#endif
+    // One cluster's part of a capacity-weighted spread.
+    struct hmp_share
+    {
+        hardware_concurrency_t first_worker; // index of the cluster's first worker thread
+        hardware_concurrency_t parts;        // the cores the share is split over (with the caller's part in the first cluster)
+        iterations_t           begin;
+        iterations_t           end;
+    }; // struct hmp_share
+
+    static hmp_config make_hmp_config( hmp_clusters_info const &, std::uint8_t number_of_clusters ) noexcept;
+    // Splits [0, iterations) for `parts` cores (strongest first) into
+    // contiguous cluster shares proportional to the clusters' used cores'
+    // combined weight. Returns the number of clusters used.
+    static std::uint8_t hmp_partition( hmp_config const &, iterations_t iterations, hardware_concurrency_t parts, hmp_share ( & shares )[ hmp_config::max_clusters ] ) noexcept;
+#endif // PSI_SWEATER_HMP
 
 #if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
-    static std::uint32_t worker_spin_count;
-#if PSI_SWEATER_USE_CALLER_THREAD
-    static std::uint32_t caller_spin_count;
-#endif // PSI_SWEATER_USE_CALLER_THREAD
+    // Adaptive spin-before-park (options::adaptive_spin): whether the work
+    // arrived within the spin window in each of the last 16 idle periods of
+    // a worker (or the spread joins of the caller - concurrent spreads race
+    // on that one, benignly: relaxed).
+    class idle_gap_history
+    {
+    public:
+        bool spin  (                                                     ) noexcept; // the prediction
+        void record( std::int64_t gap_nanoseconds, std::uint32_t spin_count ) noexcept;
+
+    private:
+        std::atomic<std::uint16_t> arrivals_{ 0xFFFF }; // optimistic start: spin (as a non adaptive shop would)
+        std::atomic<std::uint8_t > periods_ { 0      };
+    }; // class idle_gap_history
 #endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
 
-    static std::atomic<std::uint8_t> spread_work_stealing_division; // adaptive; raced by concurrent spreads by design (relaxed)
-
 private:
     struct worker_traits : psi::functionoid::default_traits
     {
@@ -126,10 +168,6 @@ private:
         static constexpr auto rtti        = false;
     }; // struct worker_traits
 
-    // TODO
-    // http://www.1024cores.net/home/lock-free-algorithms/eventcounts
-    // https://github.com/facebook/folly/blob/master/folly/experimental/EventCount.h
-
     struct spread_work_base
     {
         void const         * p_work              ;
@@ -156,16 +194,148 @@ private:
     auto number_of_worker_threads() const noexcept;
 
 #if PSI_SWEATER_EXACT_WORKER_SELECTION
-    void propagate_spread_wake( hardware_concurrency_t worker_index ) noexcept;
+    void propagate_spread_wake( hardware_concurrency_t worker_index                   ) noexcept;
+    void wake_spread_subtree  ( hardware_concurrency_t first, hardware_concurrency_t end ) noexcept;
 #endif // PSI_SWEATER_EXACT_WORKER_SELECTION
 
     auto worker_loop( hardware_concurrency_t worker_index ) noexcept;
 
+    void wait_for_work( hardware_concurrency_t slot, thrd_lite::semaphore & event, std::uint32_t spin_count ) noexcept;
+
+    // Runs a single queued item on behalf of a waiting thread (spread slices
+    // first - see work_kind) - the pool workers' thrd_lite::wait_helper.
+    bool help_waiting_worker( hardware_concurrency_t worker_index ) noexcept;
+
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+    struct spare_thread;
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
+
+public:
+#if PSI_SWEATER_TOPOLOGY
+    /// Worker placement with respect to SMT (hyperthread) siblings.
+    enum struct smt_policy : std::uint8_t
+    {
+        all_hardware_threads, ///< a worker per logical CPU (the default)
+        /// A worker per physical core, each pinned to its core's primary
+        /// hardware thread with the siblings left idle: for FP/L1 bound (e.g.
+        /// heavily vectorized) kernels that run slower with two hardware
+        /// threads fighting over a core's execution units and L1.
+        one_per_core
+    }; // enum struct smt_policy
+#endif // PSI_SWEATER_TOPOLOGY
+
+    /// Per-shop configuration, fixed at construction - so that differently
+    /// tuned shops (e.g. a latency critical one that spins and a throughput
+    /// one that splits work finely) can coexist in one process. The defaults
+    /// are those of a default constructed shop.
+    struct options
+    {
+        /// Total parallelism: the workers plus the caller thread (0 = that
+        /// offered by the hardware/CPU set). Capped by the hardware.
+        hardware_concurrency_t threads{ 0 };
+#   if PSI_SWEATER_TOPOLOGY
+        /// The CPUs to run the workers on (empty = all the process may use):
+        /// workers get placed and pinned within (the allowed part of) the
+        /// set, even on flat machines. Has no effect where the topology is
+        /// unknown or when none of the CPUs is allowed.
+        std::vector<thrd_lite::cpu_id_t> cpus;
+        smt_policy                       smt { smt_policy::all_hardware_threads };
+#   endif // PSI_SWEATER_TOPOLOGY
+
+#   if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+#   ifdef __ANDROID__
+        // The historical Android value, tuned against that platform's slow
+        // thread signals -- deliberately untouched by the general-default
+        // change below (no Android hardware in the bench fleet to re-tune it
+        // on).
+        std::uint32_t worker_spin_count{ 100 * 1000 };
+#   else
+        // Small on purpose -- see generic_config.hpp's spin-before-suspension
+        // note: ~1k nops captures the catch-the-next-dispatch win (fire
+        // flat-to-better, back-to-back small-spread join ~30-40% faster on
+        // Apple Silicon) while large counts regress both by oversubscribing
+        // the cores after a join.
+        std::uint32_t worker_spin_count{ 1000 };
+#   endif // Android
+#   if PSI_SWEATER_USE_CALLER_THREAD
+        std::uint32_t caller_spin_count{ 100 * 1000 }; // the spread join's
+#   endif // PSI_SWEATER_USE_CALLER_THREAD
+        /// Spin only when it is likely to pay off: each worker (and, for
+        /// spread joins, the caller) tracks whether, in its recent idle
+        /// periods, work arrived within the spin window (of the above spin
+        /// count) and parks immediately when it mostly did not - so that the
+        /// spin counts need no per deployment tuning to avoid burning idle
+        /// CPU on workloads with long gaps between dispatches.
+        bool adaptive_spin{ false };
+#   endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+
+        /// Bounds of the adaptive splitting of spread parts into slices for
+        /// work stealing (see dispatch_workers()): starts at the min and
+        /// grows towards the max each time the caller stalls in a join.
+        static std::uint8_t constexpr stealing_division_limit{ 16 }; // (among other reasons) not to overflow hardware_concurrency_t
+        std::uint8_t stealing_division_min{  4 };
+        std::uint8_t stealing_division_max{ 16 };
+
+#   if PSI_SWEATER_EXACT_WORKER_SELECTION
+        /// The fire_and_forget backlog a worker may accumulate before the
+        /// dispatch moves on to the next one (see next_dispatch_target()).
+        std::uint8_t sticky_dispatch_depth{ 2 };
+        /// The fan-out of the tree along which the workers of a spread wake
+        /// each other (see propagate_spread_wake()): wider = fewer wake
+        /// latencies until the last worker runs but more wake syscalls on
+        /// each waker's own path.
+        std::uint8_t wake_tree_arity{ 2 };
+#   endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+
+#   if PSI_SWEATER_USE_PARALLELIZATION_COST
+        /// The least number of iterations worth a spread part of their own -
+        /// the default for (and lower bound of) spread_the_sweat()'s
+        /// parallelizable_iterations_count.
+        iterations_t min_parallel_grain{ 1 };
+#   endif // PSI_SWEATER_USE_PARALLELIZATION_COST
+
+        /// Workers are named <prefix><worker index> (truncated to 15
+        /// characters, the Linux limit, keeping the index); empty = unnamed.
+        std::string thread_name_prefix;
+        std::size_t stack_size{ 0 }; ///< of the worker threads (0 = the platform's default)
+
+        /// Overrides the tuning fields named in a profile (as written by the
+        /// sweater_calibrate tool: key=value lines, # starts a comment);
+        /// unknown keys are skipped. Returns false if the file cannot be read.
+        bool load_profile( char const * file_path ) noexcept;
+        /// The defaults amended by the profile named by the
+        /// PSI_SWEATER_PROFILE environment variable (if set) - what the
+        /// shop() and shop( smt_policy ) constructors use.
+        static options from_environment() noexcept;
+    }; // struct options
+
 public:
     shop()         ;
+    explicit shop( options );
+#if PSI_SWEATER_TOPOLOGY
+    explicit shop( smt_policy );
+#endif // PSI_SWEATER_TOPOLOGY
    ~shop() noexcept;
 
+    options const & configuration() const noexcept { return options_; }
+
     thrd_lite::hardware_concurrency_t number_of_workers() const noexcept;
+    /// The part of number_of_workers() currently allowed to run (by the CPU
+    /// quota, the process's CPU set - see thrd_lite::process_cpus() - and
+    /// limit_cpus()) - what spreads get partitioned over. Equal to
+    /// number_of_workers() without PSI_SWEATER_TRACK_CPU_LIMITS.
+    thrd_lite::hardware_concurrency_t number_of_active_workers() const noexcept;
+
+#if PSI_SWEATER_TRACK_CPU_LIMITS
+    /// Re-evaluates the CPU limits immediately (they are otherwise polled
+    /// about once a second) - e.g. upon a notification from an orchestrator.
+    void refresh_cpu_limits() noexcept;
+    /// An application imposed limit on the number of CPUs (the caller thread
+    /// included) the shop keeps busy, on top of the tracked ones - e.g. to
+    /// leave room for a latency critical neighbour; 0 lifts it. Applied
+    /// immediately.
+    void limit_cpus( hardware_concurrency_t cpus ) noexcept;
+#endif // PSI_SWEATER_TRACK_CPU_LIMITS
 
     /// For GCD dispatch_apply/OMP-like parallel loops.
     /// \details Guarantees that <VAR>work</VAR> will not be called more than
@@ -208,6 +378,317 @@ public:
 #   endif // GCC
     }
 
+    /// Remembers which worker ran which slice of a sticky spread_the_sweat()
+    /// so that the next spread of the same loop (the same iterations and
+    /// grain over the same number of workers) hands every slice to the same
+    /// worker again - keeping a slice's data in that core's caches across
+    /// e.g. the thousands of passes of an iterative solver. Slices stay
+    /// stealable: a stolen slice is then remembered with its thief. Needs
+    /// exact worker selection (without it a sticky spread is a plain one).
+    /// Is to be used by a single spread at a time.
+    class affinity_partitioner
+    {
+    public:
+        affinity_partitioner() noexcept = default;
+        affinity_partitioner( affinity_partitioner const & ) = delete;
+        affinity_partitioner & operator=( affinity_partitioner const & ) = delete;
+
+    private:
+        friend class shop;
+
+        void record_owner( iterations_t slice_begin ) noexcept;
+
+        static constexpr std::uint16_t max_slices{ 256 };
+
+        shop const           * p_shop_          { nullptr };
+        iterations_t           iterations_      { 0       }; // of the recorded layout (zero: none yet)
+        iterations_t           first_iteration_ { 0       }; // (the caller's part precedes it)
+        hardware_concurrency_t parts_           { 0       };
+        std::uint16_t          number_of_slices_{ 0       };
+        iterations_t           slice_begin_[ max_slices + 1 ]; // (+ the end of the last one)
+        hardware_concurrency_t slice_owner_[ max_slices     ];
+    }; // class affinity_partitioner
+
+    /// spread_the_sweat() that keeps the partitioning, and the slice to
+    /// worker mapping, of its previous calls with the same partitioner.
+    template <typename F>
+    bool spread_the_sweat( affinity_partitioner & partitioner, iterations_t const iterations, F && __restrict work, iterations_t const parallelizable_iterations_count = 1 ) noexcept
+    {
+        static_assert( noexcept( work( iterations, iterations ) ), "F must be noexcept" );
+
+        struct sticky_work
+        {
+            std::remove_reference_t<F> * p_work;
+            affinity_partitioner       * p_partitioner;
+        }; // struct sticky_work
+        struct sticky_spread_wrapper : spread_work_base
+        {
+            void operator()() noexcept
+            {
+                BOOST_ASSUME( start_iteration < end_iteration );
+                auto const & sticky{ *static_cast<sticky_work const *>( p_work ) };
+                sticky.p_partitioner->record_owner( start_iteration );
+                ( *sticky.p_work )( start_iteration, end_iteration );
+                p_completion_barrier->arrive();
+            }
+        }; // struct sticky_spread_wrapper
+        static_assert( std::is_standard_layout_v<sticky_spread_wrapper> ); // required for correctness of work_t::target_as() usage
+
+        sticky_work const sticky{ std::addressof( work ), &partitioner };
+#   ifdef BOOST_GCC
+#       pragma GCC diagnostic push
+#       pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#   endif // GCC
+        return spread_work( sticky_spread_wrapper{{ .p_work = &sticky }}, iterations, parallelizable_iterations_count, nullptr, &partitioner );
+#   ifdef BOOST_GCC
+#       pragma GCC diagnostic pop
+#   endif // GCC
+    }
+
+    /// Non-blocking spread_the_sweat(): partitions and enqueues the same way
+    /// (the caller takes no part of it though) but returns without joining -
+    /// the last chunk to finish invokes <VAR>on_complete</VAR>, on whichever
+    /// thread ran it. A spread that cannot be dispatched (e.g. one issued from
+    /// within the pool) is performed synchronously, completion included.
+    /// <VAR>work</VAR> and <VAR>on_complete</VAR> are moved into a heap
+    /// allocated state that lives until <VAR>on_complete</VAR> returns.
+    /// \details <VAR>on_complete</VAR> is invoked exactly once in any case;
+    /// the return value has spread_the_sweat()'s meaning.
+    template <typename F, typename Completion>
+    requires std::is_invocable_v<Completion &>
+    bool spread_async( iterations_t const iterations, F && work, Completion && on_complete, iterations_t const parallelizable_iterations_count = 1 ) noexcept
+    {
+        using functor_t    = std::decay_t<F>;
+        using completion_t = std::decay_t<Completion>;
+        static_assert( noexcept( std::declval<functor_t &>()( iterations, iterations ) ), "F must be noexcept" );
+        static_assert( noexcept( std::declval<completion_t &>()() ), "Completion must be noexcept" );
+        static_assert( std::is_nothrow_constructible_v<functor_t, F &&> && std::is_nothrow_constructible_v<completion_t, Completion &&> );
+
+        struct async_state
+        {
+            functor_t          work              ;
+            completion_t       on_complete       ;
+            thrd_lite::barrier completion_barrier;
+        }; // struct async_state
+
+        struct async_spread_wrapper : spread_work_base
+        {
+            void operator()() noexcept
+            {
+                BOOST_ASSUME( start_iteration < end_iteration );
+                auto & state{ *static_cast<async_state *>( const_cast< void * >( p_work ) ) };
+                state.work( start_iteration, end_iteration );
+                if ( p_completion_barrier->arrive() )
+                {
+                    state.on_complete();
+                    delete &state;
+                }
+            }
+        }; // struct async_spread_wrapper
+        static_assert( std::is_standard_layout_v<async_spread_wrapper> ); // required for correctness of work_t::target_as() usage
+
+        if ( PSI_UNLIKELY( iterations == 0 ) ) [[ unlikely ]]
+        {
+            on_complete();
+            return true;
+        }
+        auto * const p_state{ new ( std::nothrow ) async_state{ std::forward<F>( work ), std::forward<Completion>( on_complete ), {} } };
+        if ( PSI_UNLIKELY( !p_state ) ) [[ unlikely ]]
+        {
+            auto const succeeded{ spread_the_sweat( iterations, work, parallelizable_iterations_count ) };
+            on_complete();
+            return succeeded;
+        }
+#   ifdef BOOST_GCC
+#       pragma GCC diagnostic push
+#       pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#   endif // GCC
+        return spread_work( async_spread_wrapper{{ .p_work = p_state }}, iterations, parallelizable_iterations_count, &p_state->completion_barrier );
+#   ifdef BOOST_GCC
+#       pragma GCC diagnostic pop
+#   endif // GCC
+    }
+
+    /// spread_async() with the completion signaled through a future.
+    template <typename F>
+    thrd_lite::future<void> spread_async( iterations_t const iterations, F && work, iterations_t const parallelizable_iterations_count = 1 )
+    {
+        auto [ promise, future ]{ thrd_lite::make_promise_future<void>() };
+        struct fulfill
+        {
+            void operator()() noexcept { promise.set_value(); }
+
+            thrd_lite::promise<void> promise;
+        }; // struct fulfill
+        (void)spread_async( iterations, std::forward<F>( work ), fulfill{ std::move( promise ) }, parallelizable_iterations_count );
+        return std::move( future );
+    }
+
+    /// A loop body of a spread_chain() (or, through loop, of a spread_many())
+    /// - only referenced: it has to outlive the call (as with
+    /// spread_the_sweat(): temporaries in the call expression do).
+    class stage
+    {
+    public:
+        // (constrained so as not to hijack copying nor to swallow arbitrary
+        // arguments - the body has to be a noexcept ( begin, end ) callable)
+        template <typename F>
+        requires( !std::is_same_v<std::remove_cvref_t<F>, stage> && std::is_nothrow_invocable_v<F &, iterations_t, iterations_t> )
+        stage( F && work ) noexcept
+            :
+            p_work_{ std::addressof( work ) },
+            invoke_{ &invoke<std::remove_reference_t<F>> }
+        {}
+
+        void operator()( iterations_t const begin, iterations_t const end ) const noexcept { invoke_( p_work_, begin, end ); }
+
+    private:
+        template <typename F>
+        static void invoke( void const * const p_work, iterations_t const begin, iterations_t const end ) noexcept
+        {
+            ( *static_cast<F *>( const_cast< void * >( p_work ) ) )( begin, end );
+        }
+
+        void const * p_work_;
+        void      (* invoke_)( void const *, iterations_t, iterations_t ) noexcept;
+    }; // class stage
+
+    /// A loop of a spread_many() batch: its iteration count and its body.
+    class loop : public stage
+    {
+    public:
+        template <typename F>
+        requires std::is_nothrow_invocable_v<F &, iterations_t, iterations_t>
+        loop( iterations_t const iterations, F && work ) noexcept : stage{ std::forward<F>( work ) }, iterations_{ iterations } {}
+
+        iterations_t iterations() const noexcept { return iterations_; }
+
+    private:
+        iterations_t iterations_;
+    }; // class loop
+
+    /// Several independent loops as a single spread: their iterations are
+    /// concatenated into one iteration space that is partitioned, dispatched
+    /// (one wake sweep) and joined (one completion barrier) like a single
+    /// spread_the_sweat() (chunks straddling loop boundaries invoke each of
+    /// the loops they cover) - instead of a dispatch and join per (small)
+    /// loop. The loops' iterations are assumed to cost about the same (the
+    /// slicing for stealing absorbs moderate differences). Empty loops are
+    /// skipped; loops with more iterations in total than a single spread can
+    /// take get spread one by one.
+    bool spread_many( std::initializer_list<loop> loops, iterations_t parallelizable_iterations_count = 1 ) noexcept;
+
+    /// A pipeline of element-wise dependent passes over the same iterations
+    /// (OpenMP's nowait stages with a static schedule): every chunk runs all
+    /// of the stages over its range, in order and on the same thread, so
+    /// stage k + 1 of a range starts as soon as stage k of that range is done
+    /// (with the range still in that core's caches) - no join (nor
+    /// re-partitioning) between the stages, only at the end. Stage k + 1 may
+    /// therefore only depend on the same iterations of the earlier stages.
+    bool spread_chain( iterations_t iterations, std::initializer_list<stage> stages, iterations_t parallelizable_iterations_count = 1 ) noexcept;
+
+    /// The team of a parallel_region(): what its participants share.
+    class region
+    {
+    public:
+        /// The number of participants (the caller included).
+        hardware_concurrency_t size() const noexcept { return barrier_.participants(); }
+
+        /// Waits for all of the participants to get here (OpenMP's barrier).
+        void sync() noexcept { barrier_.arrive_and_wait( spin_count_ ); }
+
+        /// Runs work on the first participant to get here, followed by a
+        /// sync() (OpenMP's single). All of the participants have to make the
+        /// same sequence of single() (and sync()) calls.
+        template <typename F>
+        void single( F && work ) noexcept
+        {
+            static_assert( noexcept( work() ), "F must be noexcept" );
+            if ( claim_single() )
+                work();
+            sync();
+        }
+
+        /// Runs work on the caller only - no sync() (OpenMP's master).
+        template <typename F>
+        void master( hardware_concurrency_t const participant, F && work ) noexcept
+        {
+            static_assert( noexcept( work() ), "F must be noexcept" );
+            if ( participant == 0 )
+                work();
+        }
+
+    private:
+        friend class shop;
+
+        using body_t = void ( void const * p_work, hardware_concurrency_t participant, region & ) noexcept;
+
+        region( hardware_concurrency_t participants, std::uint32_t spin_count, body_t * body, void const * p_work ) noexcept;
+
+        bool claim_single() noexcept;
+
+        void run( hardware_concurrency_t participant ) noexcept { body_( p_work_, participant, *this ); }
+
+        thrd_lite::phase_barrier            barrier_     ;
+        std::atomic<std::uint32_t>          last_single_ { 0 }; // (the phase + 1 of the last claimed single())
+        std::atomic<hardware_concurrency_t> next_member_ { 1 }; // (the participant of the next member to join)
+        std::uint32_t                       spin_count_  ;
+        body_t                            * body_        ;
+        void const                        * p_work_      ;
+        thrd_lite::barrier                  members_done_;
+    }; // class region
+
+    /// Runs work( participant, region & ) once on each of the currently idle
+    /// workers and on the caller (participant 0) - all at the same time, for
+    /// the whole duration of work (OpenMP's parallel region): a sequence of
+    /// short phases separated by region::sync() then costs a phase barrier
+    /// per phase instead of a dispatch and join (of a spread_the_sweat())
+    /// per phase. Busy workers (e.g. running a long fire_and_forget item)
+    /// are left out rather than waited for. The participants have to be
+    /// able to run concurrently so work must not wait for other shop items
+    /// (a helping wait - future::wait_helping() - of a participant runs only
+    /// fire_and_forget items, never the other members); spreads issued by
+    /// the participants are fine (their joins never pick up members either
+    /// - the busy members just leave them to the caller and the workers
+    /// outside the team). Regions do not nest nor run concurrently with each
+    /// other: a parallel_region() called from within a region (or from any
+    /// other item of the shop) or while another one is running gets a team
+    /// of just the caller.
+    template <typename F>
+    void parallel_region( F && work ) noexcept
+    {
+        static_assert( noexcept( work( hardware_concurrency_t{}, std::declval<region &>() ) ), "F must be noexcept" );
+        parallel_region_work
+        (
+            []( void const * const p_work, hardware_concurrency_t const participant, region & team ) noexcept
+            {
+                ( *static_cast<std::remove_reference_t<F> *>( const_cast< void * >( p_work ) ) )( participant, team );
+            },
+            std::addressof( work )
+        );
+    }
+
+    /// NUMA first-touch initialization: value-initializes [data, data + count)
+    /// from the workers that a subsequent spread_the_sweat( count, ... ) maps
+    /// the same iterations to (exact worker selection partitions in worker
+    /// order and, with PSI_SWEATER_TOPOLOGY, workers are ordered by node) so that
+    /// the kernel's first-touch policy places each page on the node that will
+    /// later stream through it. Best effort: stealing and concurrent spreads
+    /// can move individual slices elsewhere.
+    template <typename T>
+    bool spread_first_touch( T * const data, iterations_t const count ) noexcept
+    {
+        static_assert( std::is_nothrow_default_constructible_v<T> );
+        return spread_the_sweat
+        (
+            count,
+            [ = ]( iterations_t const begin, iterations_t const end ) noexcept
+            {
+                std::uninitialized_value_construct( data + begin, data + end );
+            }
+        );
+    }
+
     template <typename F>
     bool fire_and_forget( F && work ) noexcept( noexcept( std::is_nothrow_constructible_v<std::remove_reference_t<F>, F &&> ) )
     {
@@ -384,17 +865,80 @@ public:
 
     void set_max_allowed_threads( hardware_concurrency_t max_threads );
 
-    hardware_concurrency_t number_of_items() const noexcept;
+    hardware_concurrency_t number_of_items       () const noexcept;
+    /// Just the spread slices (queued or running) - what spreads see as
+    /// workers taken.
+    hardware_concurrency_t number_of_spread_items() const noexcept;
+
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+    /// Scope guard for work that blocks in the kernel or on foreign
+    /// synchronization (file I/O, fsync, a mutex held outside the pool...).
+    /// For its lifetime the calling worker's slot (its producer token queue
+    /// and wake event) is served by a compensating spare thread so that a
+    /// sleeping worker does not take a core's worth of throughput (and its
+    /// queued items) with it - the syscall handoff of Go's scheduler.
+    /// Spares are started lazily (at most one per worker), serve the slot
+    /// until the region ends and then retire (park) until the next handoff.
+    /// A no-op when not constructed on one of this shop's workers (or one of
+    /// their spares), on slow_thread_signals devices and when nested.
+    class blocking_region
+    {
+    public:
+        explicit blocking_region( shop & ) noexcept;
+                ~blocking_region(      ) noexcept;
+
+        blocking_region( blocking_region const & ) = delete;
+        blocking_region & operator=( blocking_region const & ) = delete;
+
+        bool compensated() const noexcept { return p_spare_ != nullptr; }
+
+    private:
+        shop               & shop_   ;
+        spare_thread * p_spare_;
+    }; // class blocking_region
+
+    template <typename F>
+    decltype( auto ) blocking( F && work ) noexcept( noexcept( std::declval<F &&>()() ) )
+    {
+        blocking_region const blocked{ *this };
+        return std::forward<F>( work )();
+    }
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
 
 #if PSI_SWEATER_HMP
+    /// Clusters go from the strongest to the weakest (workers are attributed
+    /// to clusters in index order, the caller thread to the first one). On
+    /// Linux (PSI_SWEATER_TOPOLOGY) the clusters are detected automatically
+    /// and workers are pinned accordingly.
     void configure_hmp( hmp_clusters_info config, std::uint8_t number_of_clusters );
 #endif // PSI_SWEATER_HMP
 
 private:
     void create_pool( hardware_concurrency_t size );
+#if PSI_SWEATER_HMP && PSI_SWEATER_TOPOLOGY
+    bool configure_hmp_from_topology( hardware_concurrency_t limit );
+#endif
+#if PSI_SWEATER_TOPOLOGY
+    void assign_placement() noexcept;
+    std::vector<thrd_lite::cpu_id_t> placement_allowed_cpus() const;
+#endif // PSI_SWEATER_TOPOLOGY
 
     void stop_and_destroy_pool() noexcept;
 
+    hardware_concurrency_t active_worker_threads() const noexcept;
+#if PSI_SWEATER_TRACK_CPU_LIMITS
+    void check_cpu_limits() noexcept;
+#if PSI_SWEATER_TOPOLOGY
+    void follow_affinity_changes() noexcept;
+#endif // PSI_SWEATER_TOPOLOGY
+#endif // PSI_SWEATER_TRACK_CPU_LIMITS
+
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+    spare_thread * begin_blocking(                ) noexcept;
+    void           end_blocking  ( spare_thread & ) noexcept;
+    void           spare_loop    ( spare_thread & ) noexcept;
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
+
     void perform_caller_work
     (
         iterations_t                   iterations,
@@ -414,13 +958,31 @@ private:
         thrd_lite::barrier           & completion_barrier,
         spread_work_template_t const & work_part_template
     ) noexcept;
+    iterations_t dispatch_sticky
+    (
+        affinity_partitioner         & partitioner,
+        iterations_t                   iteration,
+        hardware_concurrency_t         parts,
+        iterations_t                   per_part_iterations,
+        iterations_t                   parts_with_extra_iteration,
+        iterations_t                   iterations,
+        thrd_lite::barrier           & completion_barrier,
+        spread_work_template_t const & work_part_template
+    ) noexcept;
 #endif // PSI_SWEATER_EXACT_WORKER_SELECTION
 
+    void parallel_region_work( region::body_t * body, void const * p_work ) noexcept;
+    // A worker's (or a spare's) claim of a member of the region being
+    // staffed - returns whether it ran one (see parallel_region_work()).
+    bool join_open_region() noexcept;
+
     bool spread_work
     (
         spread_work_template_t work_part_template,
         iterations_t           iterations,
-        iterations_t           parallelizable_iterations_count
+        iterations_t           parallelizable_iterations_count,
+        thrd_lite::barrier   * p_async_barrier = nullptr,
+        affinity_partitioner * p_partitioner   = nullptr
     ) noexcept;
 
     template <typename Functor, typename ... Args>
@@ -464,7 +1026,7 @@ private:
 #       if PSI_SWEATER_EXACT_WORKER_SELECTION
             if ( !thrd_lite::slow_thread_signals )
             {
-                enqueue_succeeded = this->next_dispatch_target().enqueue( self_destructed_work{ std::forward<Args>( args )... }, this->queue_ );
+                enqueue_succeeded = this->enqueue_fire( self_destructed_work{ std::forward<Args>( args )... } );
             }
             else
 #       endif
@@ -516,7 +1078,7 @@ private:
 #       if PSI_SWEATER_EXACT_WORKER_SELECTION
             if ( !thrd_lite::slow_thread_signals )
             {
-                enqueue_succeeded = this->next_dispatch_target().enqueue( self_destructed_work{ std::forward<Args>( args )... }, this->queue_ );
+                enqueue_succeeded = this->enqueue_fire( self_destructed_work{ std::forward<Args>( args )... } );
             }
             else
 #       endif
@@ -534,6 +1096,12 @@ private:
 
     void wake_all_workers() noexcept;
 
+    // Spread slices and fire_and_forget items are queued (spread_queue_ vs
+    // queue_) and counted separately: a fire backlog neither delays spreads
+    // (workers prefer slices - a caller is blocked on them) nor throws them
+    // off exact worker selection.
+    enum class work_kind : std::uint8_t { fire, spread };
+
     // Tracked by the process-wide dispatch_tracking counter (in_flight_count()/
     // wait_until_idle()): used only by the fire_and_forget/dispatch path, whose
     // self_destructed_work wrapper pairs every increment here with an
@@ -546,11 +1114,27 @@ private:
     // wait_until_idle() to observe). Routing spread through the tracked
     // work_added() above would increment the counter once per dispatched part
     // (or once per call, depending on the code path) with nothing to ever
-    // decrement it back -- a permanent leak.
+    // decrement it back -- a permanent leak. (And so counted as
+    // work_kind::spread.)
     void work_added_untracked( hardware_concurrency_t items = 1 ) noexcept;
-    void work_completed(                                        ) noexcept;
+    void work_completed      ( work_kind, hardware_concurrency_t items = 1 ) noexcept;
+
+    hardware_concurrency_t number_of_items( bool spread_only ) const noexcept;
 
 private:
+    // A shard of the shop's work item count (see number_of_items()): every
+    // worker slot counts into its own (cache line) and all the threads
+    // outside the pool into a shared one - monotonic (wrapping) added and
+    // completed totals (per work_kind) rather than a signed balance so that
+    // a sum over the shards (read completions first) can only ever overcount.
+    struct work_item_counters
+    {
+        std::atomic<std::uint32_t> added_    [ 2 ]{};
+        std::atomic<std::uint32_t> completed_[ 2 ]{};
+    }; // struct work_item_counters
+
+    work_item_counters & work_item_shard() noexcept;
+
 #if PSI_SWEATER_EXACT_WORKER_SELECTION
     struct alignas( thrd_lite::destructive_interference_size ) worker_thread : thrd_lite::thread
     {
@@ -558,30 +1142,96 @@ private:
 
         void notify() noexcept;
 
-        bool enqueue(                     work_t &&                                         , my_queue & ) noexcept;
+        // Single items are fire_and_forget items (queue_, fire_lanes_), bulk
+        // ones spread slices (spread_queue_, spread_lanes_).
+        bool enqueue(                     work_t &&                                         , my_queue &, bool notify_worker = true ) noexcept;
         bool enqueue( std::move_iterator< work_t * >, hardware_concurrency_t number_of_items, my_queue &, bool notify_worker = true ) noexcept;
 
+        // Producer tokens are not thread safe: instead of a single token
+        // behind a lock, on which concurrent spreads and fire producers
+        // targeting the same worker would serialize, each worker has a few
+        // producer lanes - a producer takes the first one it can try_lock()
+        // (starting at a per-thread lane, see on_free_lane()) and only waits
+        // when all of them are taken.
+        static std::uint8_t constexpr producer_lanes{ 4 };
+        struct alignas( thrd_lite::destructive_interference_size ) producer_lane
+        {
+            thrd_lite::spin_lock                      mutex_;
+            std::optional<my_queue::producer_token_t> token_;
+        }; // struct producer_lane
+
+        using lanes_t = std::array<producer_lane, producer_lanes>;
+
+        template <typename Enqueue>
+        static bool on_free_lane( lanes_t &, Enqueue && ) noexcept;
+
+        // Items queued for this worker (on any of the given lanes).
+        static bool dequeue( work_t &, my_queue &, lanes_t & ) noexcept;
+        bool dequeue_spread( work_t & work, my_queue & spread_queue ) noexcept { return dequeue( work, spread_queue, spread_lanes_ ); }
+        bool dequeue_fire  ( work_t & work, my_queue &        queue ) noexcept { return dequeue( work,        queue, fire_lanes_   ); }
+
         // event_ gets its own cache line: the worker side spins/waits on (and
-        // CASes) its words while the producer side takes token_mutex_ and
-        // manipulates token_ on every enqueue -- sharing a line makes every
-        // producer token operation a coherence miss against the worker's spin
-        // (measured on the fire path's flat profile).
+        // CASes) its words while the producer side takes a lane's mutex_ and
+        // manipulates its token_ on every enqueue -- sharing a line makes
+        // every producer token operation a coherence miss against the
+        // worker's spin (measured on the fire path's flat profile).
         alignas( thrd_lite::destructive_interference_size ) thrd_lite::semaphore event_;
-        alignas( thrd_lite::destructive_interference_size ) thrd_lite::spin_lock token_mutex_; // producer tokens are not thread safe (support concurrent spread_the_sweat calls)
-        std::optional<my_queue::producer_token_t>                                token_;
+        lanes_t                                                                  spread_lanes_;
+        lanes_t                                                                  fire_lanes_;
 #   ifdef __linux__
         pid_t thread_id_ = 0;
 #   endif // Linux
+        std::atomic<hardware_concurrency_t> blocked_{ 0 }; // servers of this slot currently inside a blocking_region
+        alignas( thrd_lite::destructive_interference_size ) work_item_counters items_; // (see work_item_shard())
+        // The (exclusive) end of the contiguous range of workers, starting
+        // with this one, that this worker is to wake for the spreads that
+        // targeted it (see propagate_spread_wake()); 0 = nothing pending.
+        std::atomic<hardware_concurrency_t> wake_subtree_end_{ 0 };
+        thrd_lite::idle_stack::entry idle_; // see push_idle()
+#   if PSI_SWEATER_TOPOLOGY
+        // The CPUs the worker pins itself to (the allowed part of its CPU's
+        // LLC domain or, with smt_policy::one_per_core, exactly that CPU -
+        // computed by assign_placement() so that the starting thread has
+        // nothing to allocate) and the contiguous range of workers sharing
+        // its NUMA node - its first stealing domain. Left empty on flat
+        // hosts.
+        std::optional<cpu_affinity_mask> placement_;
+        hardware_concurrency_t           node_begin_{ 0 };
+        hardware_concurrency_t           node_end_  { 0 };
+#   endif // PSI_SWEATER_TOPOLOGY
     }; // struct worker_thread
 
-    // The worker that the next fire_and_forget item is queued on and signalled
-    // to. Round-robin rather than always pool_.front(): each worker sleeps on
-    // its OWN event and the work-stealing dequeue sits after that wait, so a
-    // worker nobody signals never reaches it. Always targeting the first worker
-    // therefore runs every dispatched item on that one thread with the rest of
-    // the pool asleep - i.e. no concurrency at all on the fire-and-forget
-    // dispatch path. spread_the_sweat is unaffected: it targets workers
-    // explicitly and wakes each one it uses.
+    // A compensating thread standing in for a blocked worker (see
+    // blocking_region): parked on its own event while retired, otherwise
+    // draining and waiting on the event/token of the worker slot it serves.
+    struct alignas( thrd_lite::destructive_interference_size ) spare_thread : thrd_lite::thread
+    {
+        using thrd_lite::thread::operator=;
+
+        thrd_lite::semaphore   event_ ;
+        shop                 * p_shop_{ nullptr };
+        hardware_concurrency_t slot_  { 0       };
+        std::atomic<bool>      busy_  { false   }; // claimed by a blocking_region (or still serving after it ended)
+    }; // struct spare_thread
+
+    // Queues a fire_and_forget item and wakes a worker for it: the most
+    // recently idled one (pop_idle()) if any, otherwise any idle one through
+    // the idle_workers_ eventcount (eventcount_parking_) or else the one it
+    // was queued on.
+    bool enqueue_fire( work_t && ) noexcept;
+
+    void            push_idle( hardware_concurrency_t slot ) noexcept;
+    worker_thread * pop_idle (                             ) noexcept;
+
+    // The worker (producer token) that the next fire_and_forget item is
+    // queued on - and, without eventcount parking, signalled to. Round-robin
+    // rather than always pool_.front(): each worker sleeps on its OWN event
+    // and the work-stealing dequeue sits after that wait, so a worker nobody
+    // signals never reaches it. Always targeting the first worker therefore
+    // runs every dispatched item on that one thread with the rest of the pool
+    // asleep - i.e. no concurrency at all on the fire-and-forget dispatch
+    // path. spread_the_sweat is unaffected: it targets workers explicitly and
+    // wakes each one it uses.
     worker_thread & next_dispatch_target() noexcept;
 
 #if defined( __ANDROID__ )
@@ -596,10 +1246,22 @@ private:
     thrd_lite::semaphore work_semaphore_;
 #endif // PSI_SWEATER_EXACT_WORKER_SELECTION
 
-    std::atomic<hardware_concurrency_t> work_items_ = 0;
+    alignas( thrd_lite::destructive_interference_size ) work_item_counters work_items_; // the shard of threads outside the pool
     std::atomic<bool                  > brexit_     = false;
 #if PSI_SWEATER_EXACT_WORKER_SELECTION
     std::atomic<std::uint32_t         > dispatch_rotor_ = 0; // see next_dispatch_target()
+    thrd_lite::idle_stack               idle_stack_;           // see push_idle()
+#endif
+#if PSI_SWEATER_EVENTCOUNT_PARKING
+    alignas( thrd_lite::destructive_interference_size ) thrd_lite::eventcount idle_workers_; // see wait_for_work()
+    bool eventcount_parking_{ !thrd_lite::slow_thread_signals && thrd_lite::semaphore::supports_broadcast() };
+#endif
+#if PSI_SWEATER_TRACK_CPU_LIMITS
+    std::atomic<hardware_concurrency_t> active_workers_    = 0; // see refresh_cpu_limits()
+    std::atomic<std::int64_t          > next_limits_check_ = 0; // steady_clock ticks
+    thrd_lite::spin_lock                limits_mutex_;          // serializes refreshes
+    hardware_concurrency_t              cpu_limit_         = 0; // see limit_cpus()
+    std::uint64_t                       affinity_signature_= 0; // of the last seen allowed CPU set (see follow_affinity_changes())
 #endif
 
     /// \todo Further queue refinements.
@@ -615,10 +1277,26 @@ private:
     /// https://github.com/Qarterd/Honeycomb/blob/master/src/common/Honey/Thread/Pool.cpp
     ///                                       (12.10.2016.) (Domagoj Saric)
     my_queue queue_;
-
-    // Caller work-stealing 'explicit' token (still a question whether worth it).
-    thrd_lite::spin_lock       consumer_token_mutex_;
-    my_queue::consumer_token_t consumer_token_;
+    my_queue spread_queue_; // (see work_kind)
+
+    // Caller work-stealing 'explicit' tokens (still a question whether worth
+    // it): per caller thread (see caller_consumer_token()), keyed by id_.
+    my_queue::consumer_token_t & caller_consumer_token() noexcept; // (for spread_queue_)
+    static std::uint64_t         new_id               () noexcept;
+    std::uint64_t const          id_{ new_id() };
+
+    options                   options_;
+    std::atomic<std::uint8_t> stealing_division_; // adaptive (within options_' bounds); raced by concurrent spreads by design (relaxed)
+    std::atomic<bool>         region_active_{ false }; // (see parallel_region())
+    std::atomic<region *>     open_region_  { nullptr }; // the one being staffed (see parallel_region_work())
+    std::atomic<hardware_concurrency_t> region_openings_{ 0 }; // its members not yet joined
+#if PSI_SWEATER_SPIN_BEFORE_SUSPENSION && PSI_SWEATER_USE_CALLER_THREAD
+    idle_gap_history          caller_idle_history_;
+#endif
+#if PSI_SWEATER_HMP
+    bool       hmp_{ false }; // until configured
+    hmp_config hmp_clusters_{};
+#endif // PSI_SWEATER_HMP
 
 #if PSI_SWEATER_MAX_HARDWARE_CONCURRENCY
 #   ifdef __ANDROID__
@@ -632,6 +1310,9 @@ private:
     using pool_threads_t = std::span<worker_thread>;
 #endif
     pool_threads_t pool_;
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+    std::unique_ptr<spare_thread[]> spares_; // pool_.size() of them, threads started on demand
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
 }; // class shop
 
 namespace events
@@ -31,6 +31,10 @@
 // https://lwn.net/Articles/352286
 #if ( defined( __ANDROID__ ) || defined( __APPLE__ ) ) && defined( __aarch64__ )
 #   define PSI_SWEATER_HMP false // implicit balancing through work stealing works better
+// Auto-configured from thrd_lite::cpu_topology() capacities (and so inert on
+// homogeneous machines): big.LITTLE ARM servers, hybrid P/E core x86.
+#elif defined( __linux__ ) && !defined( __ANDROID__ ) && !( defined( PSI_SWEATER_EXACT_WORKER_SELECTION ) && !PSI_SWEATER_EXACT_WORKER_SELECTION )
+#   define PSI_SWEATER_HMP true
 #else
 #   define PSI_SWEATER_HMP false
 #endif
@@ -46,7 +50,7 @@
 // https://www.scylladb.com/2016/06/10/read-latency-and-scylla-jmx-process
 // https://lwn.net/Articles/663879
 // Now on EVERYWHERE (was Android-only): with sticky fire dispatch in place,
-// a BRIEF spin (see shop::worker_spin_count -- the runtime knob; the
+// a BRIEF spin (see shop::options::worker_spin_count -- the per-shop knob; the
 // Android-era 100k-nop count was the pathology, not spinning itself) lets a
 // worker catch the next back-to-back item/spread without a park+wake round
 // trip. Measured on Apple Silicon @ 8 workers, sweater_shop_bench: small
@@ -78,4 +82,47 @@
 #ifndef PSI_SWEATER_EXACT_WORKER_SELECTION
 #   define PSI_SWEATER_EXACT_WORKER_SELECTION true
 #endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+
+// Topology awareness (thrd_lite::cpu_topology(), i.e. Linux sysfs): the
+// workers are laid out over the CPUs in the topology's 'locality order' (NUMA
+// node, package, L3, cluster, L2, core, SMT thread) and, on machines with
+// more than one LLC domain or NUMA node, each worker is pinned to the LLC
+// domain of its CPU. As exact worker selection hands out spread slices, wake
+// tree subtrees and dispatch rotor targets in worker index order, adjacent
+// iteration ranges then share caches (and a memory controller) rather than
+// getting scattered across sockets/chiplets. On multi-node hosts workers also
+// steal from same-node siblings before going cross node. Inert (no pinning,
+// no extra stealing pass) on single-LLC machines.
+#ifndef PSI_SWEATER_TOPOLOGY
+#if defined( __linux__ ) && !defined( __ANDROID__ ) && PSI_SWEATER_EXACT_WORKER_SELECTION
+#   define PSI_SWEATER_TOPOLOGY true
+#else
+#   define PSI_SWEATER_TOPOLOGY false
+#endif
+#endif // PSI_SWEATER_TOPOLOGY
+
+#if PSI_SWEATER_TOPOLOGY && !PSI_SWEATER_EXACT_WORKER_SELECTION
+#   error PSI_SWEATER_TOPOLOGY requires PSI_SWEATER_EXACT_WORKER_SELECTION
+#endif
+
+// Runtime CPU limit tracking: the effective parallelism (the process's CPU
+// set - its cpuset cgroup, see thrd_lite::process_cpus() - and the cgroup CPU
+// quota, with PSI_SWEATER_DOCKER_LIMITS) is re-evaluated about once a second
+// - by an idle worker, off the dispatch paths - and spreads, the wake tree
+// and fire-and-forget dispatch are limited to that many 'active' workers
+// (the rest of the pool stays parked). With PSI_SWEATER_TOPOLOGY workers are
+// also re-pinned when the CPU set changes. With PSI_SWEATER_DOCKER_LIMITS the
+// pool is then sized by the hardware rather than the startup quota so that
+// a raised quota can be put to use without a restart.
+#ifndef PSI_SWEATER_TRACK_CPU_LIMITS
+#if defined( __linux__ ) && !defined( __ANDROID__ ) && PSI_SWEATER_EXACT_WORKER_SELECTION
+#   define PSI_SWEATER_TRACK_CPU_LIMITS true
+#else
+#   define PSI_SWEATER_TRACK_CPU_LIMITS false
+#endif
+#endif // PSI_SWEATER_TRACK_CPU_LIMITS
+
+#if PSI_SWEATER_TRACK_CPU_LIMITS && !PSI_SWEATER_EXACT_WORKER_SELECTION
+#   error PSI_SWEATER_TRACK_CPU_LIMITS requires PSI_SWEATER_EXACT_WORKER_SELECTION
+#endif
 //------------------------------------------------------------------------------
@@ -93,6 +93,10 @@ void futex::wait_if_equal( value_type const desired_value, value_type ) const no
     __ulock_wait( UL_COMPARE_AND_WAIT | ULF_NO_ERRNO, const_cast< futex * >( this ), std::uint64_t{ desired_value }, 0 );
 }
 
+// No multi-wait in the __ulock family -- see futex.hpp.
+bool futex::has_wait_any() noexcept { return false; }
+void futex::wait_any_if_equal( value_type const desired_value, futex const &, value_type ) const noexcept { wait_if_equal( desired_value ); }
+
 //------------------------------------------------------------------------------
 } // namespace psi::thrd_lite
 //------------------------------------------------------------------------------
@@ -41,6 +41,10 @@ void futex::wait_if_equal( value_type const desired_value, value_type ) const no
     emscripten_futex_wait( void_cast( this ), desired_value, INFINITY );
 };
 
+// No multi-wait in the emulation -- see futex.hpp.
+bool futex::has_wait_any() noexcept { return false; }
+void futex::wait_any_if_equal( value_type const desired_value, futex const &, value_type ) const noexcept { wait_if_equal( desired_value ); }
+
 //------------------------------------------------------------------------------
 } // namespace psi::thrd_lite
 //------------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file eventcount.cpp
+/// --------------------
+///
+/// (c) Copyright Domagoj Saric 2026.
+///
+///  Use, modification and distribution are subject to the
+///  Boost Software License, Version 1.0. (See accompanying file
+///  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+///
+///  See http://www.boost.org for most recent version.
+///
+////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
+#include "eventcount.hpp"
+
+#include <boost/assert.hpp>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+// Missed-wakeup safety, two Dekker pairings:
+// - condition vs waiters_: the producer makes the condition true, issues a
+//   seq_cst fence and loads waiters_; the consumer registers in waiters_ (a
+//   seq_cst RMW) and only then re-checks the condition. Either the producer
+//   sees the registration (and bumps the epoch - which the consumer's key,
+//   read after its registration, then predates) or the consumer's re-check
+//   sees the condition.
+// - epoch_ vs sleepers_: the notifier bumps epoch_ (seq_cst RMW) then loads
+//   sleepers_ (seq_cst); commit_wait registers in sleepers_ (seq_cst RMW)
+//   then compares epoch_ with its key (seq_cst, and the futex re-checks the
+//   value atomically when parking). Either the notifier sees the sleeper
+//   (and wakes) or the sleeper sees the bump (and does not park).
+
+eventcount::key_t eventcount::prepare_wait() noexcept
+{
+    waiters_.fetch_add( 1, std::memory_order_seq_cst );
+    return epoch_.load( std::memory_order_seq_cst );
+}
+
+void eventcount::cancel_wait() noexcept
+{
+    BOOST_ASSERT( waiters_.load( std::memory_order_relaxed ) > 0 );
+    waiters_.fetch_sub( 1, std::memory_order_release );
+}
+
+void eventcount::commit_wait( key_t const key ) noexcept
+{
+    commit_wait( key, [ & ]() noexcept { epoch_.wait_if_equal( key ); } );
+}
+
+void eventcount::notify_one() noexcept
+{
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if ( waiters_.load( std::memory_order_relaxed ) == 0 ) [[ likely ]]
+        return; // the fast path: every consumer busy (or spinning before it prepares)
+    epoch_.fetch_add( 1, std::memory_order_seq_cst );
+    if ( sleepers_.load( std::memory_order_seq_cst ) ) // (prepared but not parked waiters see the bump)
+        epoch_.wake_one();
+}
+
+void eventcount::notify_all() noexcept
+{
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if ( waiters_.load( std::memory_order_relaxed ) == 0 )
+        return;
+    epoch_.fetch_add( 1, std::memory_order_seq_cst );
+    if ( sleepers_.load( std::memory_order_seq_cst ) )
+        epoch_.wake_all();
+}
+
+void eventcount::wake_all() noexcept
+{
+    epoch_.fetch_add( 1, std::memory_order_seq_cst );
+    epoch_.wake_all();
+}
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
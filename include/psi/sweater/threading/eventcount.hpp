@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file eventcount.hpp
+/// --------------------
+///
+/// (c) Copyright Domagoj Saric 2026.
+///
+///  Use, modification and distribution are subject to the
+///  Boost Software License, Version 1.0. (See accompanying file
+///  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+///
+///  See http://www.boost.org for most recent version.
+///
+////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
+#pragma once
+//------------------------------------------------------------------------------
+#include "futex.hpp"
+
+#include <atomic>
+#include <cstdint>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+// http://www.1024cores.net/home/lock-free-algorithms/eventcounts
+// https://github.com/facebook/folly/blob/main/folly/synchronization/EventCount.h
+//
+// A condition variable for lock-free conditions: a consumer that found
+// nothing to do announces itself (prepare_wait), re-checks its condition and
+// then either backs off (cancel_wait) or parks (commit_wait) - producers,
+// after making the condition true, notify. Waiters are anonymous: notify_one
+// wakes ANY one of them (no per-consumer targeting, no queue of waiters) at a
+// fence and a load when nobody waits and an epoch bump plus (only when some
+// waiter actually parked) a single FUTEX_WAKE otherwise.
+// The epoch word is exposed so that a waiter can park on it TOGETHER with a
+// private word of its own (futex::wait_any_if_equal, see commit_wait()'s
+// park hook) - e.g. a worker that also takes targeted wake-ups.
+class eventcount
+{
+public:
+    using key_t = futex::value_type;
+
+    key_t prepare_wait() noexcept;
+    void  cancel_wait () noexcept;
+    void  commit_wait ( key_t key ) noexcept;
+    // park() must return (at the latest) once epoch() no longer holds key.
+    template <typename Park>
+    void  commit_wait( key_t const key, Park && park ) noexcept
+    {
+        sleepers_.fetch_add( 1, std::memory_order_seq_cst ); // (the notify side's Dekker pair: see eventcount.cpp)
+        if ( epoch_.load( std::memory_order_seq_cst ) == key )
+            park();
+        sleepers_.fetch_sub( 1, std::memory_order_relaxed );
+        cancel_wait();
+    }
+
+    void notify_one() noexcept;
+    void notify_all() noexcept;
+    // Ungated notify_all(): for callers that already know of parked waiters
+    // (e.g. through semaphore::signal_deferred()).
+    void wake_all() noexcept;
+
+    futex const & epoch() const noexcept { return epoch_; }
+
+private:
+    futex                      epoch_    = { 0 };
+    std::atomic<std::uint32_t> waiters_  =   0  ; // between prepare_wait and cancel/commit_wait
+    std::atomic<std::uint32_t> sleepers_ =   0  ; // within commit_wait (parked or about to)
+}; // class eventcount
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
@@ -75,6 +75,17 @@ struct futex : std::atomic
     // listen_bits: which wake_bitset values this parked wait should respond to (see
     // wake_all above). Defaults to all_bits, i.e. behaviorally identical to a plain wait.
     void wait_if_equal( value_type desired_value, value_type listen_bits = all_bits ) const noexcept;
+
+    // Multi-wait: parks until either this futex or `other` is woken (or either
+    // no longer holds its expected value) -- e.g. a private wake word and a
+    // word shared by a whole group of waiters that a single wake_all() can
+    // then release at once. Only Linux (5.16+, futex_waitv) provides it;
+    // has_wait_any() reports (probed once) whether the running kernel does.
+    // Elsewhere wait_any_if_equal() degrades to a plain wait_if_equal() on
+    // this futex alone -- wakes of `other` are then NOT observed, so callers
+    // must fall back to waking the private words.
+    static bool has_wait_any() noexcept;
+    void wait_any_if_equal( value_type desired_value, futex const & other, value_type other_desired_value ) const noexcept;
 }; // struct futex
 
 //------------------------------------------------------------------------------
@@ -45,14 +45,16 @@ bool                   futex_barrier::everyone_arrived() const noexcept { return
 void futex_barrier::use_spin_wait( bool const value ) noexcept { spin_wait_ = value; }
 #endif // PSI_SWEATER_USE_CALLER_THREAD
 
-void futex_barrier::arrive() noexcept
+bool futex_barrier::arrive() noexcept
 {
     BOOST_ASSERT( counter_ > 0 );
 #if PSI_SWEATER_USE_CALLER_THREAD
     if ( PSI_LIKELY( spin_wait_ ) )
     {
-        detail::underflow_checked_dec( counter_ );
-        return;
+        auto const everyone_arrived{ counter_.fetch_sub( 1, std::memory_order_release ) == 1 };
+        if ( PSI_UNLIKELY( everyone_arrived ) )
+            std::atomic_thread_fence( std::memory_order_acquire );
+        return everyone_arrived;
     }
 #endif // PSI_SWEATER_USE_CALLER_THREAD
     
@@ -69,8 +71,10 @@ void futex_barrier::arrive() noexcept
         // contain garbage).
         BOOST_ASSERT( counter_ == 0 );
 #   endif
+        std::atomic_thread_fence( std::memory_order_acquire );
         counter_.wake_one();
     }
+    return everyone_arrived;
 }
 
 void futex_barrier::wait() noexcept
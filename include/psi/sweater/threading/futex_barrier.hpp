@@ -43,7 +43,9 @@ public:
     void use_spin_wait( bool value ) noexcept;
 #endif // PSI_SWEATER_USE_CALLER_THREAD
 
-    void arrive() noexcept;
+    // Returns whether this was the last expected arrival - in which case
+    // everything the other arrivals did happens-before its return.
+    bool arrive() noexcept;
     void wait  () noexcept;
 
 #if PSI_SWEATER_USE_CALLER_THREAD
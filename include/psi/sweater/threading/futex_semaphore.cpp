@@ -153,12 +153,57 @@ void semaphore::signal( hardware_concurrency_t const count /*= 1*/ ) noexcept
     }
 }
 
+bool semaphore::supports_broadcast() noexcept { return futex::has_wait_any(); }
+
+bool semaphore::signal_deferred( hardware_concurrency_t const count /*= 1*/ ) noexcept
+{
+    if ( !supports_broadcast() )
+    {
+        signal( count );
+        return false;
+    }
+#if PSI_SWEATER_EXACT_WORKER_SELECTION && !defined( __ANDROID__ )
+    BOOST_ASSUME( count == 1 );
+#endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+    if ( PSI_UNLIKELY( !count ) )
+        return false;
+
+    PSI_SEMA_COUNT( sema_signals );
+    auto const old_value{ value_.fetch_add( static_cast<signed_futex_value_t>( count ), std::memory_order_release ) };
+    if ( old_value >= 0 )
+        return false;
+
+    // The same deposit-then-check as signal() - only the wake is left to the
+    // caller (through the broadcast word the sleepers also park on, see
+    // sleep()).
+    auto const to_wake{ std::min( static_cast<hardware_concurrency_t>( -old_value ), count ) };
+    credits_.fetch_add( to_wake, std::memory_order_seq_cst );
+    return sleepers_.load( std::memory_order_seq_cst ) != 0;
+}
+
 void semaphore::wait() noexcept
 {
     auto const old_value{ value_.fetch_sub( 1, std::memory_order_acquire ) };
     if ( old_value > 0 )
         return;
+    BOOST_VERIFY( sleep( nullptr, 0 ) );
+}
+
+bool semaphore::wait( futex const & broadcast, futex::value_type const broadcast_value ) noexcept
+{
+    if ( !supports_broadcast() )
+    {
+        wait();
+        return true;
+    }
+    auto const old_value{ value_.fetch_sub( 1, std::memory_order_acquire ) };
+    if ( old_value > 0 )
+        return true;
+    return sleep( &broadcast, broadcast_value );
+}
 
+bool semaphore::sleep( futex const * const broadcast, futex::value_type const broadcast_value ) noexcept
+{
     // In debt: this thread owes a sleep and is entitled to exactly one credit.
     // Register, then a seq_cst fence, then load credits -- the wait side's
     // half of the Dekker pairing, fence-based so the registration itself can
@@ -175,15 +220,52 @@ void semaphore::wait() noexcept
             if ( credits_.compare_exchange_weak( credits, credits - 1, std::memory_order_acquire, std::memory_order_relaxed ) )
             {
                 detail::underflow_checked_dec( sleepers_ );
-                return;
+                return true;
             }
         }
-        PSI_SEMA_COUNT( sema_parks );
-        credits_.wait_if_equal( 0 );
+        if ( broadcast )
+        {
+            // Checked AFTER credits_: a signal_deferred() bumps the word only
+            // after its deposit - so a moved word with a (by now) paid debt
+            // finds the credit in the next round (cancel_debt() fails).
+            if ( ( broadcast->load( std::memory_order_acquire ) != broadcast_value ) && cancel_debt() )
+            {
+                detail::underflow_checked_dec( sleepers_ );
+                // A signal that picked THIS sleeper for its wake (before the
+                // cancellation) may have left a credit that another, still
+                // parked, sleeper now has to be woken for.
+                if ( credits_.load( std::memory_order_acquire ) > 0 )
+                    credits_.wake_one();
+                return false;
+            }
+            PSI_SEMA_COUNT( sema_parks );
+            credits_.wait_any_if_equal( 0, *broadcast, broadcast_value );
+        }
+        else
+        {
+            PSI_SEMA_COUNT( sema_parks );
+            credits_.wait_if_equal( 0 );
+        }
+    }
+}
+
+// Returns the sleeper's token debt (a waiter giving up on its wait). Debts are
+// fungible (any registered sleeper may consume any credit): while value_ is
+// negative some debt is still unpaid and cancelling 'ours' is equivalent to
+// cancelling that one. A non-negative value_ means every debt has been paid
+// (credits are on their way) - the caller has to take its credit instead.
+bool semaphore::cancel_debt() noexcept
+{
+    auto value{ value_.load( std::memory_order_relaxed ) };
+    while ( value < 0 )
+    {
+        if ( value_.compare_exchange_weak( value, static_cast<signed_futex_value_t>( value + 1 ), std::memory_order_relaxed, std::memory_order_relaxed ) )
+            return true;
     }
+    return false;
 }
 
-void semaphore::wait( std::uint32_t const spin_count ) noexcept
+bool semaphore::spin_wait( std::uint32_t const spin_count, futex const * const broadcast, futex::value_type const broadcast_value ) noexcept
 {
     // Spin only on the token word -- never on credits_, which belongs to
     // registered sleepers alone (what makes wakes steal-proof; see above).
@@ -193,18 +275,26 @@ void semaphore::wait( std::uint32_t const spin_count ) noexcept
         if ( value > 0 )
         {
             if ( PSI_LIKELY( try_decrement( value ) ) )
-                return;
+                return true;
         }
         else
         {
             nops( 8 );
+            if ( broadcast && ( broadcast->load( std::memory_order_relaxed ) != broadcast_value ) )
+                return false;
             value = value_.load( std::memory_order_acquire );
             ++spin_try;
         }
     }
     // value could be > 0 here (in case the change happened on the last try)
+    return false;
+}
 
-    wait();
+void semaphore::wait( std::uint32_t const spin_count ) noexcept { if ( !spin_wait( spin_count, nullptr, 0 ) ) wait(); }
+
+bool semaphore::try_wait( std::uint32_t const spin_count, futex const & broadcast, futex::value_type const broadcast_value ) noexcept
+{
+    return spin_wait( spin_count, supports_broadcast() ? &broadcast : nullptr, broadcast_value );
 }
 
 bool semaphore::try_decrement( signed_futex_value_t & __restrict last_value ) noexcept
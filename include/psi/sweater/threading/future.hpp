@@ -31,6 +31,7 @@
 //------------------------------------------------------------------------------
 #include "../detail/config.hpp"
 #include "semaphore.hpp"
+#include "wait_helper.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/core/no_exceptions_support.hpp>
@@ -75,7 +76,7 @@ namespace detail
             if constexpr ( !std::is_void_v<T> )
                 ::new ( static_cast<void *>( &storage_ ) ) T( std::forward<Args>( args ) ... );
             has_value_ = true;
-            completed_ = true;
+            completed_.store( true, std::memory_order_release );
             completion_.signal();
         }
 
@@ -83,24 +84,26 @@ namespace detail
         {
             BOOST_ASSERT( !completed_ );
             exception_ = std::move( p );
-            completed_ = true;
+            completed_.store( true, std::memory_order_release );
             completion_.signal();
         }
 
-        [[ nodiscard ]] bool completed() const noexcept { return completed_; }
+        [[ nodiscard ]] bool completed() const noexcept { return completed_.load( std::memory_order_acquire ); }
 
-        void wait() noexcept
+        void wait( bool const help = false ) noexcept
         {
             if ( !waited_ )
             {
+                if ( help ) // (see future::wait_helping())
+                    wait_helper::help_until( [ this ]() noexcept { return completed(); } );
                 completion_.wait();
                 waited_ = true;
             }
         }
 
-        T get()
+        T get( bool const help = false )
         {
-            wait();
+            wait( help );
             if ( PSI_UNLIKELY( exception_ ) )
                 std::rethrow_exception( exception_ );
             BOOST_ASSERT( has_value_ );
@@ -134,7 +137,7 @@ namespace detail
         alignas( stored_t ) std::byte   storage_[ sizeof( stored_t ) ];
         std::atomic<std::uint8_t>       owners_   { 2 }; // fixed at exactly 2 (promise + future) -- packs with the bools below
         bool                            has_value_{ false };
-        bool                            completed_{ false };
+        std::atomic<bool>               completed_{ false }; // (also polled by wait_helper::help_until())
         bool                            waited_   { false };
     }; // class future_state
 } // namespace detail
@@ -256,6 +259,20 @@ public:
 
     T get() { BOOST_ASSERT( p_state_ ); return p_state_->get(); }
 
+    /// Opt-in variants for waits on a pool worker (e.g. a dispatch_lite()
+    /// of a dependency from within a work item): until the result is ready
+    /// the worker runs queued items of its pool (see wait_helper) instead of
+    /// parking - which keeps a saturated pool from deadlocking on such
+    /// waits. Re-entrancy: the helped items are arbitrary other work, run on
+    /// this thread's stack, in the middle of the caller - they must not
+    /// need anything the caller holds (a non-recursive lock, exclusive
+    /// access to the caller's state...) and see the caller's thread_locals;
+    /// the wait can also last until the helped item completes, well after
+    /// the result got ready. Plain wait()/get() elsewhere.
+    void wait_helping() noexcept { BOOST_ASSERT( p_state_ ); p_state_->wait( true ); }
+
+    T get_helping() { BOOST_ASSERT( p_state_ ); return p_state_->get( true ); }
+
     [[ nodiscard ]] static std::pair<promise<T>, future<T>> make()
     {
         auto & state{ *new detail::future_state<T>() }; // owners_ starts at 2 (promise + future)
@@ -52,14 +52,16 @@ bool                   generic_barrier::everyone_arrived() const noexcept { retu
 void generic_barrier::use_spin_wait( bool const value ) noexcept { spin_wait_ = value; }
 #endif // PSI_SWEATER_USE_CALLER_THREAD
 
-void generic_barrier::arrive() noexcept
+bool generic_barrier::arrive() noexcept
 {
     BOOST_ASSERT( counter_ > 0 );
 #if PSI_SWEATER_USE_CALLER_THREAD
     if ( PSI_LIKELY( spin_wait_ ) )
     {
-        detail::underflow_checked_dec( counter_ );
-        return;
+        auto const everyone_arrived{ counter_.fetch_sub( 1, std::memory_order_release ) == 1 };
+        if ( PSI_UNLIKELY( everyone_arrived ) )
+            std::atomic_thread_fence( std::memory_order_acquire );
+        return everyone_arrived;
     }
 #endif // PSI_SWEATER_USE_CALLER_THREAD
     // Here we have to perform the notification while holding the lock to
@@ -70,6 +72,7 @@ void generic_barrier::arrive() noexcept
     bool const everyone_arrived{ counter_.fetch_sub( 1, std::memory_order_relaxed ) == 1 };
     if ( PSI_UNLIKELY( everyone_arrived ) )
         event_.notify_one();
+    return everyone_arrived; // (the mutex orders the arrivals)
 }
 
 void generic_barrier::wait() noexcept
@@ -140,6 +140,24 @@ void semaphore::wait() noexcept
     --waiters_;
 }
 
+// No futex (hence no multi-wait) behind this impl: the broadcast word is
+// ignored and deferred signals are plain ones (see semaphore.hpp).
+bool semaphore::supports_broadcast() noexcept { return false; }
+bool semaphore::signal_deferred( hardware_concurrency_t const count ) noexcept { signal( count ); return false; }
+bool semaphore::wait( futex const &, futex::value_type ) noexcept { wait(); return true; }
+bool semaphore::try_wait( std::uint32_t const spin_count, futex const &, futex::value_type ) noexcept
+{
+    auto value{ value_.load( std::memory_order_acquire ) };
+    for ( auto spin_try{ 0U }; spin_try < spin_count; ++spin_try )
+    {
+        if ( ( value > 0 ) && value_.compare_exchange_weak( value, value - 1, std::memory_order_acquire, std::memory_order_relaxed ) )
+            return true;
+        nops( 8 );
+        value = value_.load( std::memory_order_acquire );
+    }
+    return false;
+}
+
 //------------------------------------------------------------------------------
 } // namespace psi::thrd_lite
 //------------------------------------------------------------------------------
@@ -23,13 +23,11 @@
 #   include <emscripten/threading.h>
 #endif // __EMSCRIPTEN_PTHREADS__
 #ifdef __linux__
-#   include <sys/sysinfo.h>
-#endif // __linux__
-
-#if PSI_SWEATER_DOCKER_LIMITS
 #   include <boost/assert.hpp>
 
 #   include <fcntl.h>
+#   include <sched.h>
+#   include <sys/sysinfo.h>
 #   include <sys/types.h>
 #   include <unistd.h>
 
@@ -38,7 +36,7 @@
 #   include <cstdio>
 #   include <cstdlib>
 #   include <cstring>
-#endif // PSI_SWEATER_DOCKER_LIMITS
+#endif // __linux__
 
 #ifdef _MSC_VER
 #   include <boost/preprocessor/stringize.hpp> // current MS STL yvals.h no longer provides _STRINGIZE
@@ -58,13 +56,7 @@ namespace psi::thrd_lite
 {
 //------------------------------------------------------------------------------
 
-#if PSI_SWEATER_MAX_HARDWARE_CONCURRENCY == 1
-
-hardware_concurrency_t hardware_concurrency_current() noexcept { return 1; }
-hardware_concurrency_t get_hardware_concurrency_max() noexcept { return 1; }
-
-#elif PSI_SWEATER_DOCKER_LIMITS
-
+#ifdef __linux__
 namespace
 {
     // Enough for a cgroup mount point plus the deepest cgroup path the kernel
@@ -72,12 +64,12 @@ namespace
     auto constexpr path_size{ 512 };
 
     // Reads at most size-1 bytes and NUL terminates. Returns false if the file
-    // does not exist (the normal outcome for the cgroup hierarchy this build is
-    // not running under) or cannot be read.
+    // does not exist (the normal outcome for the cgroup hierarchy the process
+    // is not running under) or cannot be read.
     bool read_text( char const * const file_path, char * const buffer, std::size_t const size ) noexcept
     {
         BOOST_ASSERT( size > 1 );
-        auto const fd{ ::open( file_path, O_RDONLY, 0 ) };
+        auto const fd{ ::open( file_path, O_RDONLY | O_CLOEXEC, 0 ) };
         if ( fd == -1 )
             return false;
         auto const bytes_read{ ::read( fd, buffer, size - 1 ) };
@@ -88,6 +80,217 @@ namespace
         return true;
     }
 
+    // `controller` as a whole entry in a comma separated v1 controller list
+    // (`cpu`, `cpuset` and `cpuacct` are different controllers and must not
+    // match each other).
+    bool has_controller( char const * entry, char const * const end, char const * const controller ) noexcept
+    {
+        while ( entry < end )
+        {
+            auto const * entry_end{ std::strchr( entry, ',' ) };
+            if ( !entry_end || ( entry_end > end ) )
+                entry_end = end;
+            auto const length{ std::strlen( controller ) };
+            if ( ( static_cast<std::size_t>( entry_end - entry ) == length ) && ( std::strncmp( entry, controller, length ) == 0 ) )
+                return true;
+            entry = entry_end + 1;
+        }
+        return false;
+    }
+
+    // The path of the process's own cgroup within the hierarchy, from
+    // /proc/self/cgroup: "0::<path>" for the unified hierarchy, or
+    // "<id>:<controllers>:<path>" with the given controller among the
+    // controllers for v1 (a null `v1_controller`: the unified hierarchy).
+    // Yields the empty string for the hierarchy root (and when there is no
+    // such line) so that concatenation with the mount point cannot produce
+    // a "//".
+    void self_cgroup( char const * const proc_self_cgroup, char const * const v1_controller, char * const out, std::size_t const size ) noexcept
+    {
+        out[ 0 ] = '\0';
+        for ( auto const * line{ proc_self_cgroup }; line && *line; )
+        {
+            auto const * const eol     { std::strchr( line, '\n' ) };
+            auto const * const line_end{ eol ? eol : ( line + std::strlen( line ) ) };
+            auto const * const field2  { std::strchr( line, ':' ) };
+            auto const * const field3  { ( field2 && ( field2 < line_end ) ) ? std::strchr( field2 + 1, ':' ) : nullptr };
+            if ( field3 && ( field3 < line_end ) )
+            {
+                auto const matches{ !v1_controller ? ( ( field2 + 1 ) == field3 ) : has_controller( field2 + 1, field3, v1_controller ) };
+                if ( matches )
+                {
+                    auto const length{ std::min( static_cast<std::size_t>( line_end - field3 - 1 ), size - 1 ) };
+                    std::memcpy( out, field3 + 1, length );
+                    out[ length ] = '\0';
+                    if ( ( length == 1 ) && ( out[ 0 ] == '/' ) ) // the hierarchy root
+                        out[ 0 ] = '\0';
+                    return;
+                }
+            }
+            line = eol ? ( eol + 1 ) : nullptr;
+        }
+    }
+
+    // The kernel's "cpulist" format: comma separated decimal ids and inclusive
+    // ranges, e.g. "0-3,8-11\n". False for an empty list.
+    bool parse_cpu_list( char const * list, cpu_set_t & cpus ) noexcept
+    {
+        CPU_ZERO( &cpus );
+        for ( ; ; )
+        {
+            char * end;
+            auto const first{ std::strtoul( list, &end, 10 ) };
+            if ( end == list )
+                break;
+            auto last{ first };
+            if ( *end == '-' )
+            {
+                list = end + 1;
+                last = std::strtoul( list, &end, 10 );
+            }
+            for ( auto cpu{ first }; ( cpu <= last ) && ( cpu < CPU_SETSIZE ); ++cpu )
+                CPU_SET( cpu, &cpus );
+            if ( *end != ',' )
+                break;
+            list = end + 1;
+        }
+        return CPU_COUNT( &cpus ) != 0;
+    }
+
+    // The effective CPUs of the process's cpuset cgroup (v2
+    // cpuset.cpus.effective - of the closest ancestor that has the cpuset
+    // controller enabled - or v1 cpuset.effective_cpus): what the process as
+    // a whole is confined to, and what container runtimes change at runtime.
+    bool cgroup_cpus( cpu_set_t & cpus ) noexcept
+    {
+        char proc_self[ 1024 ];
+        if ( !read_text( "/proc/self/cgroup", proc_self, sizeof( proc_self ) ) )
+            return false;
+
+        static constexpr char v2_root[]{ "/sys/fs/cgroup"        };
+        static constexpr char v1_root[]{ "/sys/fs/cgroup/cpuset" };
+
+        char relative_path[ path_size ];
+        char path         [ path_size + sizeof( v1_root ) + 32 ];
+        char list         [ 4096 ];
+
+        self_cgroup( proc_self, nullptr, relative_path, sizeof( relative_path ) );
+        for ( auto dir_length{ std::strlen( relative_path ) }; ; )
+        {
+            std::snprintf( path, sizeof( path ), "%s%.*s/cpuset.cpus.effective", v2_root, static_cast<int>( dir_length ), relative_path );
+            if ( read_text( path, list, sizeof( list ) ) )
+                return parse_cpu_list( list, cpus );
+            auto const * const parent_end{ static_cast<char const *>( ::memrchr( relative_path, '/', dir_length ) ) };
+            if ( !parent_end )
+                break;
+            dir_length = static_cast<std::size_t>( parent_end - relative_path );
+        }
+
+        self_cgroup( proc_self, "cpuset", relative_path, sizeof( relative_path ) );
+        std::snprintf( path, sizeof( path ), "%s%s/cpuset.effective_cpus", v1_root, relative_path );
+        if ( read_text( path, list, sizeof( list ) ) )
+            return parse_cpu_list( list, cpus );
+        std::snprintf( path, sizeof( path ), "%s%s/cpuset.cpus", v1_root, relative_path ); // (pre 4.17 kernels)
+        return read_text( path, list, sizeof( list ) ) && parse_cpu_list( list, cpus );
+    }
+
+    // The affinity the process was started with (taskset, numactl or simply
+    // the cpuset's CPUs at the time), taken once: later sched_setaffinity()
+    // calls are per thread - e.g. the main thread pinning itself - and do not
+    // change what the process as a whole may use. It stays a limit only if
+    // it was narrower than the cpuset (a launch time choice of the user) -
+    // otherwise it is just the cpuset's as of startup and the cpuset is
+    // followed instead.
+    struct startup_affinity_t
+    {
+        startup_affinity_t() noexcept
+        {
+            known = ( ::sched_getaffinity( ::getpid(), sizeof( mask ), &mask ) == 0 ) && CPU_COUNT( &mask );
+            cpu_set_t cpuset;
+            if ( known && cgroup_cpus( cpuset ) )
+            {
+                cpu_set_t common;
+                CPU_AND( &common, &mask, &cpuset );
+                narrower = !CPU_EQUAL( &common, &cpuset );
+            }
+            else
+            {
+                narrower = known;
+            }
+        }
+
+        cpu_set_t mask;
+        bool      known;
+        bool      narrower; // than the cpuset
+    } const startup_affinity __attribute__(( init_priority( 101 ) ));
+
+    // The number of CPUs the process may currently run on, -1 if unknown.
+    int affinity_cpus() noexcept
+    {
+        cpu_set_t cpus;
+        return process_cpus( cpus ) ? CPU_COUNT( &cpus ) : -1;
+    }
+
+    [[ maybe_unused ]]
+    int limit_to_allowed( int const cpus ) noexcept
+    {
+#   ifdef __ANDROID__
+        // Left out: Android's cpusets track an app's foreground/background
+        // state rather than what the app was given to run on.
+        return cpus;
+#   else
+        auto const allowed{ affinity_cpus() };
+        return ( allowed > 0 ) ? std::min( cpus, allowed ) : cpus;
+#   endif
+    }
+
+    // Only by a launch affinity narrower than the cpuset (which can grow at
+    // runtime): the ceiling for pools that follow the CPU set at runtime.
+    [[ maybe_unused ]]
+    int limit_to_launch_affinity( int const cpus ) noexcept
+    {
+#   ifdef __ANDROID__
+        return cpus;
+#   else
+        return startup_affinity.narrower ? std::min( cpus, CPU_COUNT( &startup_affinity.mask ) ) : cpus;
+#   endif
+    }
+} // anonymous namespace
+
+bool process_cpus( cpu_set_t & cpus ) noexcept
+{
+    cpu_set_t cpuset;
+    if ( !cgroup_cpus( cpuset ) )
+    {
+        cpus = startup_affinity.mask;
+        return startup_affinity.known;
+    }
+    if ( startup_affinity.narrower )
+    {
+        CPU_AND( &cpus, &cpuset, &startup_affinity.mask );
+        if ( CPU_COUNT( &cpus ) ) // (the cpuset moved away from the launch set altogether: the cpuset wins)
+            return true;
+    }
+    cpus = cpuset;
+    return true;
+}
+
+hardware_concurrency_t cpus_allowed_current() noexcept { return static_cast<hardware_concurrency_t>( std::max( affinity_cpus(), 0 ) ); }
+#else
+hardware_concurrency_t cpus_allowed_current() noexcept { return 0; }
+#endif // Linux
+
+#if PSI_SWEATER_MAX_HARDWARE_CONCURRENCY == 1
+
+hardware_concurrency_t hardware_concurrency_current      () noexcept { return 1; }
+hardware_concurrency_t get_hardware_concurrency_max      () noexcept { return 1; }
+hardware_concurrency_t cpu_quota_current                 () noexcept { return 0; }
+hardware_concurrency_t get_hardware_concurrency_unlimited() noexcept { return 1; }
+
+#elif PSI_SWEATER_DOCKER_LIMITS
+
+namespace
+{
     int read_int( char const * const file_path ) noexcept
     {
         char value[ 64 ];
@@ -151,54 +354,6 @@ namespace
         }
     }
 
-    // `cpu` as a whole entry in a comma separated v1 controller list (`cpuset`
-    // and `cpuacct` are different controllers and must not match).
-    bool has_cpu_controller( char const * entry, char const * const end ) noexcept
-    {
-        while ( entry < end )
-        {
-            auto const * entry_end{ std::strchr( entry, ',' ) };
-            if ( !entry_end || ( entry_end > end ) )
-                entry_end = end;
-            if ( ( ( entry_end - entry ) == 3 ) && ( std::strncmp( entry, "cpu", 3 ) == 0 ) )
-                return true;
-            entry = entry_end + 1;
-        }
-        return false;
-    }
-
-    // The path of the process's own cgroup within the hierarchy, from
-    // /proc/self/cgroup: "0::<path>" for the unified hierarchy, or
-    // "<id>:<controllers>:<path>" with `cpu` among the controllers for v1.
-    // Yields the empty string for the hierarchy root (and when there is no
-    // such line) so that concatenation with the mount point cannot produce
-    // a "//".
-    void self_cgroup( char const * const proc_self_cgroup, bool const v2, char * const out, std::size_t const size ) noexcept
-    {
-        out[ 0 ] = '\0';
-        for ( auto const * line{ proc_self_cgroup }; line && *line; )
-        {
-            auto const * const eol     { std::strchr( line, '\n' ) };
-            auto const * const line_end{ eol ? eol : ( line + std::strlen( line ) ) };
-            auto const * const field2  { std::strchr( line, ':' ) };
-            auto const * const field3  { ( field2 && ( field2 < line_end ) ) ? std::strchr( field2 + 1, ':' ) : nullptr };
-            if ( field3 && ( field3 < line_end ) )
-            {
-                auto const matches{ v2 ? ( ( field2 + 1 ) == field3 ) : has_cpu_controller( field2 + 1, field3 ) };
-                if ( matches )
-                {
-                    auto const length{ std::min( static_cast<std::size_t>( line_end - field3 - 1 ), size - 1 ) };
-                    std::memcpy( out, field3 + 1, length );
-                    out[ length ] = '\0';
-                    if ( ( length == 1 ) && ( out[ 0 ] == '/' ) ) // the hierarchy root
-                        out[ 0 ] = '\0';
-                    return;
-                }
-            }
-            line = eol ? ( eol + 1 ) : nullptr;
-        }
-    }
-
     auto get_docker_limit() noexcept
     {
         // https://bugs.openjdk.java.net/browse/JDK-8146115
@@ -227,11 +382,11 @@ namespace
         char relative_path[ path_size ];
         char dir          [ path_size + sizeof( v1_root ) ];
 
-        self_cgroup( proc_self, true, relative_path, sizeof( relative_path ) );
+        self_cgroup( proc_self, nullptr, relative_path, sizeof( relative_path ) );
         std::snprintf( dir, sizeof( dir ), "%s%s", v2_root, relative_path );
         auto const v2_limit{ scan_branch( dir, sizeof( v2_root ) - 1, true ) };
 
-        self_cgroup( proc_self, false, relative_path, sizeof( relative_path ) );
+        self_cgroup( proc_self, "cpu", relative_path, sizeof( relative_path ) );
         std::snprintf( dir, sizeof( dir ), "%s%s", v1_root, relative_path );
         auto const v1_limit{ scan_branch( dir, sizeof( v1_root ) - 1, false ) };
 
@@ -253,10 +408,18 @@ hardware_concurrency_t get_hardware_concurrency_max() noexcept
     // Obey docker limits even when someone attempts to create a pool with
     // more threads than allowed by the Docker container but return the number
     // of all CPUs when there is no Docker CPU quota in place.
-    return static_cast<hardware_concurrency_t>( ( docker_quota != -1 ) ? docker_quota : get_nprocs_conf() );
+    return static_cast<hardware_concurrency_t>( limit_to_allowed( ( docker_quota != -1 ) ? docker_quota : get_nprocs_conf() ) );
 }
 
-hardware_concurrency_t hardware_concurrency_current() noexcept { return static_cast<hardware_concurrency_t>( ( docker_quota != -1 ) ? docker_quota : get_nprocs() ); }
+hardware_concurrency_t hardware_concurrency_current() noexcept { return static_cast<hardware_concurrency_t>( limit_to_allowed( ( docker_quota != -1 ) ? docker_quota : get_nprocs() ) ); }
+
+hardware_concurrency_t cpu_quota_current() noexcept
+{
+    auto const quota{ get_docker_limit() };
+    return static_cast<hardware_concurrency_t>( ( quota != -1 ) ? quota : 0 );
+}
+
+hardware_concurrency_t get_hardware_concurrency_unlimited() noexcept { return static_cast<hardware_concurrency_t>( limit_to_launch_affinity( get_nprocs_conf() ) ); }
 
 #else // generic/standard impl
 
@@ -268,7 +431,7 @@ hardware_concurrency_t get_hardware_concurrency_max() noexcept
         emscripten_has_threading_support() ? emscripten_num_logical_cores() : 1
 #   elif defined( __linux__ )
         // libcpp std::thread::hardware_concurrency() returns the dynamic number of active cores.
-        get_nprocs_conf()
+        limit_to_allowed( get_nprocs_conf() )
 #   else
         std::thread::hardware_concurrency()
 #   endif
@@ -282,13 +445,24 @@ hardware_concurrency_t hardware_concurrency_current() noexcept
 #   if defined( __EMSCRIPTEN_PTHREADS__ )
         get_hardware_concurrency_max()
 #   elif defined( __linux__ )
-        get_nprocs()
+        limit_to_allowed( get_nprocs() )
 #   else
         std::thread::hardware_concurrency()
 #   endif
     );
 }
 
+hardware_concurrency_t cpu_quota_current() noexcept { return 0; }
+
+hardware_concurrency_t get_hardware_concurrency_unlimited() noexcept
+{
+#   if defined( __linux__ ) && !defined( __EMSCRIPTEN_PTHREADS__ )
+    return static_cast<hardware_concurrency_t>( limit_to_launch_affinity( get_nprocs_conf() ) );
+#   else
+    return get_hardware_concurrency_max();
+#   endif
+}
+
 #endif // impl
 
 // http://clang-developers.42468.n3.nabble.com/Clang-equivalent-to-attribute-init-priority-td4034229.html
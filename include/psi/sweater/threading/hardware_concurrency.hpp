@@ -45,6 +45,10 @@
 
 #include <cstddef>
 #include <cstdint>
+
+#ifdef __linux__
+#   include <sched.h>
+#endif // __linux__
 //------------------------------------------------------------------------------
 namespace psi::thrd_lite
 {
@@ -73,9 +77,33 @@ inline constexpr std::size_t destructive_interference_size
 #endif
 };
 
+// On Linux both are limited to the CPUs the process is allowed to run on
+// (taskset, cpusets - see cpus_allowed_current()).
 hardware_concurrency_t hardware_concurrency_current() noexcept;
 hardware_concurrency_t get_hardware_concurrency_max() noexcept;
 
+#ifdef __linux__
+// The CPUs the process as a whole may run on: its cpuset cgroup's effective
+// CPUs, further limited by the affinity the process was started with if that
+// was narrower (taskset, numactl). Per-thread affinity changes made later -
+// e.g. the main thread pinning itself - do not count. False where unknown.
+bool process_cpus( cpu_set_t & ) noexcept;
+#endif // __linux__
+
+// The number of process_cpus() re-read on every call, 0 where unknown. For
+// tracking runtime changes - a few small cgroupfs reads, i.e. cold paths.
+hardware_concurrency_t cpus_allowed_current() noexcept;
+
+// The cgroup CPU quota (in whole CPUs, see get_docker_limit()) re-read on
+// every call, 0 when none is in place (or without PSI_SWEATER_DOCKER_LIMITS).
+// For tracking runtime limit changes (e.g. vertical autoscaling of a
+// container) - a handful of small cgroupfs reads, i.e. for cold paths only.
+hardware_concurrency_t cpu_quota_current() noexcept;
+// get_hardware_concurrency_max() without the (startup) CPU quota and cpuset
+// applied (only a narrower launch affinity - see process_cpus()): the ceiling
+// for pools that track them at runtime.
+hardware_concurrency_t get_hardware_concurrency_unlimited() noexcept;
+
 extern struct hardware_concurrency_max_t
 {
     hardware_concurrency_t const value{ get_hardware_concurrency_max() };
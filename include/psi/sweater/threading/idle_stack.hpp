@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file idle_stack.hpp
+/// --------------------
+///
+/// (c) Copyright Domagoj Saric 2026.
+///
+///  Use, modification and distribution are subject to the
+///  Boost Software License, Version 1.0. (See accompanying file
+///  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+///
+///  See http://www.boost.org for most recent version.
+///
+////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
+#pragma once
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+// A lock-free LIFO of idle threads (a Treiber stack of thread indices with
+// an ABA tag in the head word) - popping yields the most recently idled one.
+// The per thread entries live with their owners (e.g. in a pool's worker
+// objects, indexed 0 to 2^32 - 2) rather than in the stack.
+// Entries are not removed when their threads get woken by other means: the
+// owner marks its entry busy (entry::leave()) and pop() skips such stale
+// entries. A thread re-idling while (still) listed only refreshes its idle
+// flag - the popper clears the listed flag before checking the idle one so
+// that one of the two always sees the other (a thread can at worst remain
+// listed as stale or be popped once more than it idled, i.e. receive a
+// spurious signal).
+class idle_stack
+{
+public:
+    using index_t = std::uint32_t;
+    static index_t constexpr none{ static_cast<index_t>( -1 ) };
+
+    class entry
+    {
+    public:
+        void leave() noexcept { idle_.store( false, std::memory_order_relaxed ); } // (the owner got woken and is busy again)
+
+    private: friend class idle_stack;
+        std::atomic<index_t> next_  { 0     }; // the entry below (index + 1, 0 = bottom)
+        std::atomic<bool   > listed_{ false };
+        std::atomic<bool   > idle_  { false };
+    }; // class entry
+
+    // Only with no concurrent push()es or pop()s.
+    void clear() noexcept { head_.store( 0, std::memory_order_relaxed ); }
+
+    void push( index_t const index, entry & idler ) noexcept
+    {
+        idler.idle_.store( true, std::memory_order_seq_cst );
+        if ( idler.listed_.exchange( true, std::memory_order_seq_cst ) )
+            return;
+        auto head{ head_.load( std::memory_order_relaxed ) };
+        std::uint64_t new_head;
+        do
+        {
+            idler.next_.store( static_cast<index_t>( head ), std::memory_order_relaxed );
+            new_head = ( ( ( head >> 32 ) + 1 ) << 32 ) | ( index + 1U );
+        } while ( !head_.compare_exchange_weak( head, new_head, std::memory_order_release, std::memory_order_relaxed ) );
+    }
+
+    // The index of the most recently pushed (still) idle entry, marked busy,
+    // or none. entry_of( index ) -> entry &.
+    template <typename EntryOf>
+    index_t pop( EntryOf && entry_of ) noexcept
+    {
+        auto head{ head_.load( std::memory_order_acquire ) };
+        while ( static_cast<index_t>( head ) ) // (nobody idle: a single load)
+        {
+            auto const   index{ static_cast<index_t>( head ) - 1 };
+            entry      & idler{ entry_of( index ) };
+            auto const   next { ( ( ( head >> 32 ) + 1 ) << 32 ) | idler.next_.load( std::memory_order_relaxed ) };
+            if ( !head_.compare_exchange_weak( head, next, std::memory_order_acquire, std::memory_order_acquire ) )
+                continue;
+            idler.listed_.store( false, std::memory_order_seq_cst );
+            if ( idler.idle_.exchange( false, std::memory_order_seq_cst ) )
+                return index;
+            head = next; // stale
+        }
+        return none;
+    }
+
+private:
+    std::atomic<std::uint64_t> head_{ 0 }; // ABA tag << 32 | top index + 1
+}; // class idle_stack
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
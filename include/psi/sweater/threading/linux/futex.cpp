@@ -19,7 +19,9 @@
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <cerrno>
 #include <climits>
+#include <cstdint>
 
 //------------------------------------------------------------------------------
 namespace psi::thrd_lite
@@ -52,6 +54,22 @@ namespace
 
     void futex_wait( void const * const addr, std::uint32_t const val             ) noexcept { return futex( addr, FUTEX_WAIT, val             ); }
 	void futex_wake( void const * const addr, std::uint32_t const waiters_to_wake ) noexcept { return futex( addr, FUTEX_WAKE, waiters_to_wake ); }
+
+    // futex_waitv (Linux 5.16+): spelled out here rather than taken from
+    // <linux/futex.h>/<sys/syscall.h> so that builds against older kernel
+    // headers still get it (the syscall number is the same on every
+    // architecture and struct futex_waitv is part of the stable ABI).
+#ifndef SYS_futex_waitv
+    constexpr long SYS_futex_waitv{ 449 };
+#endif
+    constexpr std::uint32_t futex_size_u32{ 2 }; // FUTEX2_SIZE_U32 (FUTEX_32)
+    struct waitv_entry
+    {
+        std::uint64_t val;
+        std::uint64_t uaddr;
+        std::uint32_t flags;
+        std::uint32_t reserved;
+    }; // struct waitv_entry (struct futex_waitv)
 } // anonymous namespace
 
 void futex::wake_one(                                              ) const noexcept { wake( 1 ); }
@@ -68,6 +86,26 @@ void futex::wait_if_equal( value_type const desired_value, value_type const list
     futex_bitset( this, FUTEX_WAIT_BITSET, desired_value, listen_bits );
 };
 
+bool futex::has_wait_any() noexcept
+{
+    // An empty wait list is rejected with EINVAL by kernels that know the
+    // syscall (ENOSYS otherwise, EPERM from seccomp filters that predate it).
+    static bool const supported{ ( ::syscall( SYS_futex_waitv, nullptr, 0, 0, nullptr, 0 ) == -1 ) && ( errno == EINVAL ) };
+    return supported;
+}
+
+void futex::wait_any_if_equal( value_type const desired_value, futex const & other, value_type const other_desired_value ) const noexcept
+{
+    if ( !has_wait_any() ) { wait_if_equal( desired_value ); return; }
+    waitv_entry const waiters[ 2 ]
+    {
+        { desired_value      , reinterpret_cast<std::uintptr_t>( this   ), futex_size_u32 | FUTEX_PRIVATE_FLAG, 0 },
+        { other_desired_value, reinterpret_cast<std::uintptr_t>( &other ), futex_size_u32 | FUTEX_PRIVATE_FLAG, 0 }
+    };
+    // (no timeout: the clockid argument is ignored)
+    ::syscall( SYS_futex_waitv, waiters, 2, 0, nullptr, 0 );
+}
+
 //------------------------------------------------------------------------------
 } // namespace psi::thrd_lite
 //------------------------------------------------------------------------------
@@ -42,6 +42,7 @@
 #include "../detail/config.hpp"
 #include "future.hpp" // broken_promise
 #include "semaphore.hpp"
+#include "wait_helper.hpp"
 
 #include <boost/assert.hpp>
 #include <boost/core/no_exceptions_support.hpp>
@@ -102,24 +103,26 @@ namespace detail
                 ::new ( static_cast<void *>( &storage_ ) ) outcome_result<T>( outcome_ns::success() );
             else
                 ::new ( static_cast<void *>( &storage_ ) ) outcome_result<T>( std::forward<Args>( args ) ... );
-            completed_ = true;
+            completed_.store( true, std::memory_order_release );
             completion_.signal();
         }
 
-        [[ nodiscard ]] bool completed() const noexcept { return completed_; }
+        [[ nodiscard ]] bool completed() const noexcept { return completed_.load( std::memory_order_acquire ); }
 
-        void wait() noexcept
+        void wait( bool const help = false ) noexcept
         {
             if ( !waited_ )
             {
+                if ( help ) // (see future::wait_helping())
+                    wait_helper::help_until( [ this ]() noexcept { return completed(); } );
                 completion_.wait();
                 waited_ = true;
             }
         }
 
-        outcome_result<T> get() noexcept
+        outcome_result<T> get( bool const help = false ) noexcept
         {
-            wait();
+            wait( help );
             BOOST_ASSERT( completed_ );
             return std::move( *reinterpret_cast<outcome_result<T> *>( &storage_ ) );
         }
@@ -142,7 +145,7 @@ namespace detail
         semaphore                                    completion_;
         alignas( outcome_result<T> ) std::byte        storage_[ sizeof( outcome_result<T> ) ];
         std::atomic<std::uint8_t>                     owners_   { 2 }; // fixed at exactly 2 -- packs with the two bools below
-        bool                                          completed_{ false };
+        std::atomic<bool>                             completed_{ false }; // (also polled by wait_helper::help_until())
         bool                                          waited_   { false };
     }; // class outcome_state
 } // namespace detail
@@ -258,8 +261,11 @@ public:
     [[ nodiscard ]] bool valid() const noexcept { return p_state_ != nullptr; }
 
     void wait() noexcept { BOOST_ASSERT( p_state_ ); p_state_->wait(); }
+    /// See future::wait_helping() (and its re-entrancy caveats).
+    void wait_helping() noexcept { BOOST_ASSERT( p_state_ ); p_state_->wait( true ); }
 
     [[ nodiscard ]] outcome_result<T> get() noexcept { BOOST_ASSERT( p_state_ ); return p_state_->get(); }
+    [[ nodiscard ]] outcome_result<T> get_helping() noexcept { BOOST_ASSERT( p_state_ ); return p_state_->get( true ); }
 
     [[ nodiscard ]] static std::pair<outcome_promise<T>, outcome_future<T>> make()
     {
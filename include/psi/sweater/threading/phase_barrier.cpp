@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file phase_barrier.cpp
+/// -----------------------
+///
+/// (c) Copyright Domagoj Saric 2026.
+///
+///  Use, modification and distribution are subject to the
+///  Boost Software License, Version 1.0. (See accompanying file
+///  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+///
+///  See http://www.boost.org for most recent version.
+///
+////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
+#include "phase_barrier.hpp"
+
+#include "cpp/spin_lock.hpp" // only for nops
+
+#include <boost/assert.hpp>
+#include <mutex>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+#if PSI_THRD_LITE_HAS_FUTEX
+
+futex_phase_barrier::futex_phase_barrier( hardware_concurrency_t const participants ) noexcept : participants_{ participants } { BOOST_ASSERT( participants > 0 ); }
+
+void futex_phase_barrier::initialize( hardware_concurrency_t const participants ) noexcept
+{
+    BOOST_ASSERT( participants > 0 );
+    BOOST_ASSERT_MSG( arrived_.load( std::memory_order_relaxed ) == 0, "Mid phase" );
+    participants_ = participants;
+}
+
+// The arrivals form a release sequence on arrived_ (acq_rel RMWs) so the last
+// one sees everybody's work and publishes it, along with the reset of
+// arrived_ for the next phase, through the phase word. The phase_ vs
+// sleepers_ Dekker pairing is eventcount's (see eventcount.cpp): a waiter
+// registers in sleepers_ before re-checking the phase, the last arrival
+// advances the phase before checking sleepers_ (all seq_cst) - either the
+// waiter sees the new phase or the last arrival sees the sleeper and wakes
+// it (and the futex re-checks the value atomically when parking).
+bool futex_phase_barrier::arrive_and_wait( std::uint32_t spin_count ) noexcept
+{
+    auto const phase{ phase_.load( std::memory_order_acquire ) }; // (cannot move before this participant arrives)
+    if ( arrived_.fetch_add( 1, std::memory_order_acq_rel ) + 1 == participants_ )
+    {
+        arrived_.store( 0, std::memory_order_relaxed );
+        phase_.fetch_add( 1, std::memory_order_seq_cst );
+        if ( sleepers_.load( std::memory_order_seq_cst ) )
+            phase_.wake_all();
+        return true;
+    }
+
+    while ( spin_count-- )
+    {
+        if ( phase_.load( std::memory_order_acquire ) != phase )
+            return false;
+        nops( 8 );
+    }
+
+    sleepers_.fetch_add( 1, std::memory_order_seq_cst );
+    while ( phase_.load( std::memory_order_seq_cst ) == phase )
+        phase_.wait_if_equal( phase );
+    sleepers_.fetch_sub( 1, std::memory_order_relaxed );
+    return false;
+}
+
+#endif // PSI_THRD_LITE_HAS_FUTEX
+
+//------------------------------------------------------------------------------
+// condvar impl
+//------------------------------------------------------------------------------
+
+generic_phase_barrier::generic_phase_barrier( hardware_concurrency_t const participants ) noexcept : participants_{ participants } { BOOST_ASSERT( participants > 0 ); }
+
+void generic_phase_barrier::initialize( hardware_concurrency_t const participants ) noexcept
+{
+    BOOST_ASSERT( participants > 0 );
+    BOOST_ASSERT_MSG( arrived_.load( std::memory_order_relaxed ) == 0, "Mid phase" );
+    participants_ = participants;
+}
+
+bool generic_phase_barrier::arrive_and_wait( std::uint32_t spin_count ) noexcept
+{
+    auto const phase{ phase_.load( std::memory_order_acquire ) };
+    {
+        std::scoped_lock<mutex> lock{ mutex_ };
+        if ( arrived_.fetch_add( 1, std::memory_order_relaxed ) + 1 == participants_ ) // (the mutex orders the arrivals)
+        {
+            arrived_.store( 0, std::memory_order_relaxed );
+            phase_.store( phase + 1, std::memory_order_release );
+            event_.notify_all();
+            return true;
+        }
+    }
+
+    while ( spin_count-- )
+    {
+        if ( phase_.load( std::memory_order_acquire ) != phase )
+            return false;
+        nops( 8 );
+    }
+
+    std::scoped_lock<mutex> lock{ mutex_ };
+    while ( phase_.load( std::memory_order_relaxed ) == phase )
+        event_.wait( mutex_ );
+    return false;
+}
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
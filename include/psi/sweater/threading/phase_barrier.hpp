@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file phase_barrier.hpp
+/// -----------------------
+///
+/// (c) Copyright Domagoj Saric 2026.
+///
+///  Use, modification and distribution are subject to the
+///  Boost Software License, Version 1.0. (See accompanying file
+///  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+///
+///  See http://www.boost.org for most recent version.
+///
+////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
+#pragma once
+//------------------------------------------------------------------------------
+#include "condvar.hpp"
+#include "futex.hpp" // PSI_THRD_LITE_HAS_FUTEX
+#include "hardware_concurrency.hpp"
+#include "mutex.hpp"
+
+#include <atomic>
+#include <cstdint>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+// A reusable barrier for a fixed group of participants that all wait for
+// each other, phase after phase (std::barrier's arrive_and_wait() - unlike
+// barrier, which is a single use join of arrivals by a single waiter). A
+// phase ends with the last arrival: it resets the count, advances the phase
+// word and wakes whoever got as far as parking (waiters spin for a while
+// first - phases are expected to be short). Everything the participants did
+// before arriving happens-before anything any of them does after the wait.
+// Futex backed where there is a futex backend, condvar based (the
+// generic_phase_barrier, built everywhere so that it gets tested everywhere)
+// otherwise - see barrier.hpp.
+#if PSI_THRD_LITE_HAS_FUTEX
+class futex_phase_barrier
+{
+public:
+    explicit futex_phase_barrier( hardware_concurrency_t participants ) noexcept;
+
+    // Only between phases, with no waiters.
+    void initialize( hardware_concurrency_t participants ) noexcept;
+
+    hardware_concurrency_t participants() const noexcept { return participants_; }
+    // The number of completed phases (wrapping) - stable for a participant
+    // between two of its waits.
+    std::uint32_t          phase       () const noexcept { return phase_.load( std::memory_order_acquire ); }
+
+    // Returns whether this was the last arrival (of the phase).
+    bool arrive_and_wait( std::uint32_t spin_count = 0 ) noexcept;
+
+private:
+    hardware_concurrency_t              participants_;
+    std::atomic<hardware_concurrency_t> arrived_ { 0 };
+    futex                               phase_   { 0 };
+    std::atomic<hardware_concurrency_t> sleepers_{ 0 };
+}; // class futex_phase_barrier
+#endif // PSI_THRD_LITE_HAS_FUTEX
+
+class generic_phase_barrier
+{
+public:
+    explicit generic_phase_barrier( hardware_concurrency_t participants ) noexcept;
+
+    // Only between phases, with no waiters.
+    void initialize( hardware_concurrency_t participants ) noexcept;
+
+    hardware_concurrency_t participants() const noexcept { return participants_; }
+    // The number of completed phases (wrapping) - stable for a participant
+    // between two of its waits.
+    std::uint32_t          phase       () const noexcept { return phase_.load( std::memory_order_acquire ); }
+
+    // Returns whether this was the last arrival (of the phase).
+    bool arrive_and_wait( std::uint32_t spin_count = 0 ) noexcept;
+
+private:
+    hardware_concurrency_t              participants_;
+    std::atomic<hardware_concurrency_t> arrived_{ 0 };
+    std::atomic<std::uint32_t>          phase_  { 0 };
+    mutex                               mutex_  ;
+    condition_variable                  event_  ;
+}; // class generic_phase_barrier
+
+#if PSI_THRD_LITE_HAS_FUTEX
+using phase_barrier = futex_phase_barrier;
+#else
+using phase_barrier = generic_phase_barrier;
+#endif
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
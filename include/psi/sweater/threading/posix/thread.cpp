@@ -23,8 +23,11 @@
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
 #include <cerrno>
+#include <climits> // PTHREAD_STACK_MIN
 #include <cstdint>
+#include <cstring>
 
 #ifdef __ANDROID__
 #include <sys/time.h>
@@ -141,9 +144,37 @@ bool thread_impl::bind_to_cpu( pid_t const thread_id, affinity_mask const mask )
 #endif
 }
 
-int thread_impl::create( thread_procedure const start_routine, void * const arg ) noexcept
+PSI_COLD
+bool thread_impl::set_active_thread_name( char const * const name ) noexcept
+{
+#if defined( __linux__ )
+    char truncated[ 16 ]; // TASK_COMM_LEN (longer names are refused with ERANGE)
+    std::strncpy( truncated, name, sizeof( truncated ) - 1 );
+    truncated[ sizeof( truncated ) - 1 ] = '\0';
+    return ::pthread_setname_np( ::pthread_self(), truncated ) == 0;
+#elif defined( __APPLE__ )
+    return ::pthread_setname_np( name ) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+int thread_impl::create( thread_procedure const start_routine, void * const arg, std::size_t const stack_size ) noexcept
 {
-    auto const error{ pthread_create( &handle_, nullptr, start_routine, arg ) };
+    int error;
+    if ( stack_size )
+    {
+        pthread_attr_t attributes;
+        BOOST_VERIFY( ::pthread_attr_init( &attributes ) == 0 );
+        BOOST_VERIFY( ::pthread_attr_setstacksize( &attributes, std::max<std::size_t>( stack_size, PTHREAD_STACK_MIN ) ) == 0 );
+        error = pthread_create( &handle_, &attributes, start_routine, arg );
+        BOOST_VERIFY( ::pthread_attr_destroy( &attributes ) == 0 );
+    }
+    else
+    {
+        error = pthread_create( &handle_, nullptr, start_routine, arg );
+    }
     if ( PSI_UNLIKELY( error ) )
     {
         BOOST_ASSUME( error == EAGAIN ); // any other error indicates a programmer error
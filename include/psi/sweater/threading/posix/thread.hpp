@@ -19,6 +19,8 @@
 
 #include <pthread.h>
 
+#include <cstddef>
+
 #if defined( __linux )
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -97,6 +99,10 @@ public:
 
     static bool bind_to_cpu( pid_t, affinity_mask ) noexcept;
 
+    // Names the calling thread (for debuggers, profilers, top -H...). Longer
+    // names get truncated to the OS's limit (15 characters on Linux).
+    static bool set_active_thread_name( char const * name ) noexcept;
+
 protected:
     // https://stackoverflow.com/questions/43819314/default-member-initializer-needed-within-definition-of-enclosing-class-outside
     constexpr thread_impl() noexcept {};
@@ -104,7 +110,7 @@ protected:
 
     using thread_procedure = void * (*)( void * );
 
-    int create( thread_procedure start_routine, void * arg ) noexcept;
+    int create( thread_procedure start_routine, void * arg, std::size_t stack_size = 0 /*platform default*/ ) noexcept;
 
 protected:
     native_handle_type handle_{};
@@ -72,6 +72,28 @@ public:
     void wait(                          ) noexcept;
     void wait( std::uint32_t spin_count ) noexcept;
 
+    // Waiting for a token OR a shared 'broadcast' futex word (an eventcount's
+    // epoch, say) to move off a given value - parking on both at once
+    // (futex::wait_any_if_equal). The broadcast overloads return whether a
+    // token was taken (false: the word moved first - no token consumed).
+    // Also enables batched wakes for a GROUP of semaphores (e.g. one per
+    // worker) whose waiters watch the same broadcast word: signal_deferred()
+    // deposits the token (and wake credit) but leaves the wake syscall to the
+    // caller - who, after signalling the whole group, bumps and wake_all()s
+    // the broadcast word once iff any call returned true. Without multi-wait
+    // support (supports_broadcast() == false) the broadcast word is ignored
+    // by the waits and signal_deferred() is a plain signal() that always
+    // returns false. Every wait on a semaphore that receives deferred signals
+    // has to go through the broadcast overloads.
+    static bool supports_broadcast() noexcept;
+
+    [[ nodiscard ]] bool signal_deferred( hardware_concurrency_t count = 1 ) noexcept;
+
+    // spin_count spins for a token, giving up early once the broadcast word
+    // moves (never parks).
+    bool try_wait( std::uint32_t spin_count, futex const & broadcast, futex::value_type broadcast_value ) noexcept;
+    bool wait    (                           futex const & broadcast, futex::value_type broadcast_value ) noexcept;
+
     // Approximate signaled-but-unconsumed token count (negative: that many
     // waiters in debt/parked) -- a single relaxed load, for load-balancing
     // heuristics (see generic.cpp's next_dispatch_target). Instantly stale;
@@ -84,6 +106,9 @@ private:
     using signed_futex_value_t = std::make_signed_t< futex::value_type >;
 
     bool try_decrement( signed_futex_value_t & last_value ) noexcept;
+    bool spin_wait    ( std::uint32_t spin_count, futex const * broadcast, futex::value_type broadcast_value ) noexcept;
+    bool sleep        (                           futex const * broadcast, futex::value_type broadcast_value ) noexcept;
+    bool cancel_debt  (                                                                                      ) noexcept;
 
 private:
     // Exact sleeper accounting (see futex_semaphore.cpp's design-doc comment):
@@ -31,6 +31,7 @@
 #include <stdexcept>
 #endif // BOOST_NO_EXCEPTIONS
 
+#include <cstddef>
 #include <memory>
 #include <mutex>
 #include <type_traits>
@@ -100,6 +101,15 @@ public:
 
     template <class F>
     thread & operator=( F && functor )
+    {
+        start( std::forward<F>( functor ) );
+        return *this;
+    }
+
+    /// Starts the thread running <VAR>functor</VAR> - same as assignment but
+    /// allowing for a non-default stack size (0 = the platform's default).
+    template <class F>
+    void start( F && functor, std::size_t const stack_size = 0 )
     {
         using ret_t   = std::invoke_result_t<thread_procedure, void *>;
         using Functor = std::decay_t<F>;
@@ -123,7 +133,8 @@ public:
                     tiny_functor();
                     return 0;
                 },
-                context
+                context,
+                stack_size
             );
         }
         else
@@ -141,7 +152,8 @@ public:
                     functor();
                     return 0;
                 },
-                &context
+                &context,
+                stack_size
             );
         }
         else
@@ -155,11 +167,11 @@ public:
                     (*p_functor)();
                     return 0;
                 },
-                p_functor.get()
+                p_functor.get(),
+                stack_size
             );
             p_functor.release();
         }
-        return *this;
     }
 
     auto native_handle() const noexcept { return handle_; }
@@ -180,10 +192,10 @@ public:
 
 private:
     PSI_COLD
-    void create( thread_procedure const start_routine, void * const arg )
+    void create( thread_procedure const start_routine, void * const arg, std::size_t const stack_size )
     {
         BOOST_ASSERT_MSG( !joinable(), "A thread already created" );
-        auto const error( thread_impl::create( start_routine, arg ) );
+        auto const error( thread_impl::create( start_routine, arg, stack_size ) );
         if ( PSI_UNLIKELY( error ) )
         {
 #       ifdef BOOST_NO_EXCEPTIONS
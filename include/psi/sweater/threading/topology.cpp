@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file topology.cpp
+/// ------------------
+///
+/// (c) Copyright Domagoj Saric 2026.
+///
+///  Use, modification and distribution are subject to the
+///  Boost Software License, Version 1.0. (See accompanying file
+///  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+///
+///  See http://www.boost.org for most recent version.
+///
+////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
+#include "topology.hpp"
+#include "hardware_concurrency.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+
+#ifdef __linux__
+#   include <fcntl.h>
+#   include <sched.h>
+#   include <unistd.h>
+
+#   include <cstdio>
+#   include <cstdlib>
+#   include <functional>
+#   include <tuple>
+#endif // __linux__
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+#ifdef __linux__
+namespace
+{
+    // Reads at most size-1 bytes and NUL terminates. Returns false if the file
+    // does not exist (or cannot be read) - the normal outcome for sysfs
+    // attributes a given kernel/architecture does not provide.
+    bool read_text( char const * const file_path, char * const buffer, std::size_t const size ) noexcept
+    {
+        BOOST_ASSERT( size > 1 );
+        auto const fd{ ::open( file_path, O_RDONLY | O_CLOEXEC, 0 ) };
+        if ( fd == -1 )
+            return false;
+        auto const bytes_read{ ::read( fd, buffer, size - 1 ) };
+        BOOST_VERIFY( ::close( fd ) == 0 );
+        if ( bytes_read <= 0 )
+            return false;
+        buffer[ bytes_read ] = '\0';
+        return true;
+    }
+
+    // The kernel's "cpulist" format (also used for node lists): comma
+    // separated decimal ids and inclusive ranges, e.g. "0-3,8-11\n".
+    template <typename Consumer>
+    void parse_list( char const * list, Consumer && consumer ) noexcept
+    {
+        for ( ; ; )
+        {
+            char * end;
+            auto const first{ std::strtoul( list, &end, 10 ) };
+            if ( end == list )
+                return;
+            auto last{ first };
+            if ( *end == '-' )
+            {
+                list = end + 1;
+                last = std::strtoul( list, &end, 10 );
+            }
+            for ( auto id{ first }; id <= last; ++id )
+                consumer( static_cast<cpu_id_t>( id ) );
+            if ( *end != ',' )
+                return;
+            list = end + 1;
+        }
+    }
+
+    auto constexpr sysfs_system_dir{ "/sys/devices/system" };
+
+    // The lowest CPU id of a (sorted) cpulist: the domain identifier. Yields
+    // `fallback` for a missing attribute.
+    cpu_id_t domain_of( char const * const path, cpu_id_t const fallback ) noexcept
+    {
+        char list[ 4096 ];
+        if ( !read_text( path, list, sizeof( list ) ) )
+            return fallback;
+        char * end;
+        auto const first{ std::strtoul( list, &end, 10 ) };
+        return ( end == list ) ? fallback : static_cast<cpu_id_t>( first );
+    }
+
+    unsigned long read_number( char const * const path, unsigned long const fallback ) noexcept
+    {
+        char text[ 32 ];
+        if ( !read_text( path, text, sizeof( text ) ) )
+            return fallback;
+        char * end;
+        auto const value{ std::strtoul( text, &end, 10 ) };
+        return ( end == text ) ? fallback : value;
+    }
+
+    // cpu_capacity where provided, otherwise cpufreq's cpuinfo_max_freq
+    // normalized to the fastest CPU - and then grouped into classes.
+    void assign_capacities( std::span<cpu_info> const cpus, char const * const system_dir )
+    {
+        std::vector<unsigned long> raw( cpus.size() );
+        char path[ 512 ];
+        auto from_capacity{ true };
+        for ( std::size_t i{ 0 }; i < cpus.size(); ++i )
+        {
+            std::snprintf( path, sizeof( path ), "%s/cpu/cpu%u/cpu_capacity", system_dir, cpus[ i ].id );
+            raw[ i ] = read_number( path, 0 );
+            from_capacity &= ( raw[ i ] != 0 );
+        }
+        if ( !from_capacity )
+        {
+            for ( std::size_t i{ 0 }; i < cpus.size(); ++i )
+            {
+                std::snprintf( path, sizeof( path ), "%s/cpu/cpu%u/cpufreq/cpuinfo_max_freq", system_dir, cpus[ i ].id );
+                raw[ i ] = read_number( path, 0 );
+            }
+        }
+        auto const max_raw{ *std::max_element( raw.begin(), raw.end() ) };
+        for ( std::size_t i{ 0 }; i < cpus.size(); ++i )
+        {
+            auto const value{ raw[ i ] ? raw[ i ] : max_raw }; // partial information: assume big
+            cpus[ i ].capacity = max_raw ? static_cast<std::uint16_t>( std::max<unsigned long>( 1, value * 1024 / max_raw ) ) : 1024;
+        }
+
+        // Class 'tops': the capacities, descending, that are not within 1/8
+        // below the previous top.
+        std::vector<std::uint16_t> tops( cpus.size() );
+        std::transform( cpus.begin(), cpus.end(), tops.begin(), []( cpu_info const & cpu ) noexcept { return cpu.capacity; } );
+        std::sort( tops.begin(), tops.end(), std::greater<>{} );
+        auto last_top{ tops.begin() };
+        for ( auto const level : tops )
+        {
+            if ( level < *last_top - *last_top / 8 )
+                *++last_top = level;
+        }
+        tops.erase( last_top + 1, tops.end() );
+        for ( auto & cpu : cpus )
+        {
+            auto const tops_above{ std::count_if( tops.begin(), tops.end(), [ & ]( std::uint16_t const top ) noexcept { return top >= cpu.capacity; } ) };
+            cpu.capacity_class = static_cast<std::uint8_t>( tops_above - 1 );
+        }
+    }
+} // anonymous namespace
+
+std::vector<numa_node> read_numa_nodes( char const * const system_dir )
+{
+    std::vector<numa_node> nodes;
+    char list[ 4096 ]; // a cpulist of a node of a big box can get long-ish
+    char path[ 512 ];
+    std::snprintf( path, sizeof( path ), "%s/node/online", system_dir );
+    if ( !read_text( path, list, sizeof( list ) ) )
+        return nodes;
+    std::vector<std::uint16_t> node_ids;
+    parse_list( list, [ & ]( cpu_id_t const node_id ) { node_ids.push_back( node_id ); } );
+    for ( auto const node_id : node_ids )
+    {
+        std::snprintf( path, sizeof( path ), "%s/node/node%u/cpulist", system_dir, node_id );
+        if ( !read_text( path, list, sizeof( list ) ) )
+            continue;
+        numa_node node{ .id = node_id, .cpus = {} };
+        parse_list( list, [ & ]( cpu_id_t const cpu ) { node.cpus.push_back( cpu ); } );
+        if ( !node.cpus.empty() )
+            nodes.push_back( std::move( node ) );
+    }
+    return nodes;
+}
+
+std::vector<cpu_info> read_cpu_topology( char const * const system_dir )
+{
+    std::vector<cpu_info> cpus;
+    char list[ 4096 ];
+    char path[ 512 ];
+    std::snprintf( path, sizeof( path ), "%s/cpu/online", system_dir );
+    if ( !read_text( path, list, sizeof( list ) ) )
+        return cpus;
+    parse_list( list, [ & ]( cpu_id_t const cpu ) { cpus.push_back( { .id = cpu, .core = cpu, .smt_index = 0, .cluster = cpu, .l2 = cpu, .l3 = cpu, .package = 0, .numa_node = 0, .capacity = 1024, .capacity_class = 0 } ); } );
+    if ( cpus.empty() )
+        return cpus;
+
+    auto const nodes{ read_numa_nodes( system_dir ) };
+    bool has_l3{ false };
+    for ( auto & cpu : cpus )
+    {
+        auto const id{ cpu.id };
+        std::snprintf( path, sizeof( path ), "%s/cpu/cpu%u/topology/thread_siblings_list", system_dir, id );
+        if ( read_text( path, list, sizeof( list ) ) )
+        {
+            bool first{ true };
+            parse_list( list, [ & ]( cpu_id_t const sibling )
+            {
+                if ( first ) { cpu.core = sibling; first = false; }
+                cpu.smt_index += ( sibling < id );
+            } );
+        }
+        std::snprintf( path, sizeof( path ), "%s/cpu/cpu%u/topology/cluster_cpus_list", system_dir, id );
+        cpu.cluster = domain_of( path, id );
+        std::snprintf( path, sizeof( path ), "%s/cpu/cpu%u/topology/package_cpus_list", system_dir, id );
+        cpu.package = domain_of( path, 0 );
+        for ( auto index{ 0 }; ; ++index )
+        {
+            std::snprintf( path, sizeof( path ), "%s/cpu/cpu%u/cache/index%d/level", system_dir, id, index );
+            char level[ 16 ];
+            if ( !read_text( path, level, sizeof( level ) ) )
+                break;
+            std::snprintf( path, sizeof( path ), "%s/cpu/cpu%u/cache/index%d/type", system_dir, id, index );
+            char type[ 32 ];
+            if ( read_text( path, type, sizeof( type ) ) && ( type[ 0 ] == 'I' ) ) // Instruction (vs Data/Unified)
+                continue;
+            std::snprintf( path, sizeof( path ), "%s/cpu/cpu%u/cache/index%d/shared_cpu_list", system_dir, id, index );
+            switch ( std::atoi( level ) )
+            {
+                case 2: cpu.l2 = domain_of( path, id ); break;
+                case 3: cpu.l3 = domain_of( path, id ); has_l3 = true; break;
+                default: break;
+            }
+        }
+        for ( std::uint16_t node{ 0 }; node < nodes.size(); ++node )
+        {
+            if ( std::binary_search( nodes[ node ].cpus.begin(), nodes[ node ].cpus.end(), id ) )
+                cpu.numa_node = node;
+        }
+    }
+    assign_capacities( cpus, system_dir );
+    // No L3: the L2 is the LLC - fold it so that l3 always names the LLC
+    // domain (and sorting does not split L2 domains by CPU id).
+    if ( !has_l3 )
+    {
+        for ( auto & cpu : cpus )
+            cpu.l3 = cpu.l2;
+    }
+
+    std::sort
+    (
+        cpus.begin(), cpus.end(),
+        []( cpu_info const & left, cpu_info const & right ) noexcept
+        {
+            return
+                std::tie( left .numa_node, left .package, left .capacity_class, left .l3, left .cluster, left .l2, left .core, left .smt_index, left .id ) <
+                std::tie( right.numa_node, right.package, right.capacity_class, right.l3, right.cluster, right.l2, right.core, right.smt_index, right.id );
+        }
+    );
+    return cpus;
+}
+#else
+std::vector<numa_node> read_numa_nodes  ( char const * ) { return {}; }
+std::vector<cpu_info > read_cpu_topology( char const * ) { return {}; }
+#endif // __linux__
+
+std::span<numa_node const> numa_nodes() noexcept
+{
+#ifdef __linux__
+    static std::vector<numa_node> const nodes{ read_numa_nodes( sysfs_system_dir ) };
+    return nodes;
+#else
+    return {};
+#endif
+}
+
+std::span<cpu_info const> cpu_topology() noexcept
+{
+#ifdef __linux__
+    static std::vector<cpu_info> const cpus{ read_cpu_topology( sysfs_system_dir ) };
+    return cpus;
+#else
+    return {};
+#endif
+}
+
+std::vector<cpu_id_t> allowed_cpus()
+{
+    std::vector<cpu_id_t> cpus;
+#ifdef __linux__
+    cpu_set_t mask;
+    if ( !process_cpus( mask ) )
+        return cpus;
+    for ( cpu_id_t cpu{ 0 }; cpu < CPU_SETSIZE; ++cpu )
+    {
+        if ( CPU_ISSET( cpu, &mask ) )
+            cpus.push_back( cpu );
+    }
+#endif // __linux__
+    return cpus;
+}
+
+std::vector<cpu_id_t> llc_domain_cpus( cpu_id_t const cpu )
+{
+    std::vector<cpu_id_t> domain;
+    auto const cpus{ cpu_topology() };
+    for ( auto const & info : cpus )
+    {
+        if ( info.id == cpu )
+        {
+            for ( auto const & other : cpus )
+            {
+                if ( ( other.l3 == info.l3 ) && ( other.capacity_class == info.capacity_class ) )
+                    domain.push_back( other.id );
+            }
+            std::sort( domain.begin(), domain.end() );
+            break;
+        }
+    }
+    return domain;
+}
+
+std::vector<slot_range> numa_slot_ranges( std::span<cpu_info const> const cpus, std::uint16_t const slots, std::uint16_t const first )
+{
+    std::vector<slot_range> ranges;
+    if ( cpus.empty() )
+        return ranges;
+    ranges.resize( slots );
+    auto const node_of{ [ & ]( std::uint16_t const slot ) noexcept { return cpus[ ( first + slot ) % cpus.size() ].numa_node; } };
+    for ( std::uint16_t begin{ 0 }; begin < slots; )
+    {
+        auto end{ begin };
+        while ( ( end < slots ) && ( node_of( end ) == node_of( begin ) ) )
+            ++end;
+        std::fill( ranges.begin() + begin, ranges.begin() + end, slot_range{ begin, end } );
+        begin = end;
+    }
+    return ranges;
+}
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file topology.hpp
+/// ------------------
+///
+/// (c) Copyright Domagoj Saric 2026.
+///
+///  Use, modification and distribution are subject to the
+///  Boost Software License, Version 1.0. (See accompanying file
+///  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+///
+///  See http://www.boost.org for most recent version.
+///
+////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
+#pragma once
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <span>
+#include <vector>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+using cpu_id_t = std::uint16_t;
+
+struct numa_node
+{
+    std::uint16_t         id  ; // the kernel's node number (/sys/devices/system/node/node<id>)
+    std::vector<cpu_id_t> cpus; // logical CPUs local to the node, ascending
+}; // struct numa_node
+
+// The online NUMA nodes (Linux sysfs: /sys/devices/system/node), ordered by
+// node id and discovered once (on first use). Empty where the platform offers
+// no such information - a single node holding every CPU is what it amounts to
+// anyway - and nodes without CPUs (memory-only, e.g. CXL or HBM expanders)
+// are skipped as there is nothing to place on them.
+std::span<numa_node const> numa_nodes() noexcept;
+
+// One online logical CPU's place in the machine (Linux sysfs:
+// /sys/devices/system/cpu/cpu<id>/topology and .../cache/index*). Sharing
+// domains (core, cluster, cache, package) are identified by their lowest
+// numbered CPU - unique per domain and meaningful across all the levels
+// without any renumbering. A CPU whose kernel does not report a level (no
+// clusters on most x86 boxes, no L3 on many ARM SoCs) is its own domain at
+// that level.
+// Heterogeneous (big.LITTLE, P/E core) machines are described by the
+// capacity fields: the kernel's cpu_capacity (the scheduler's 0-1024 scale of
+// relative per-core throughput, exported on ARM/RISC-V and hybrid x86) or,
+// lacking that, the cpufreq maximum frequency scaled to the same range.
+// CPUs within 1/8 of each other's capacity (e.g. Turbo Boost Max 'favoured'
+// cores) form one capacity class, with class 0 holding the biggest cores.
+struct cpu_info
+{
+    cpu_id_t      id            ;
+    cpu_id_t      core          ; // SMT siblings share it
+    std::uint16_t smt_index     ; // position among the core's hardware threads (0 = the 'primary' thread)
+    cpu_id_t      cluster       ; // scheduler/cache cluster (cluster_cpus_list)
+    cpu_id_t      l2            ; // shared L2 domain
+    cpu_id_t      l3            ; // shared L3 (LLC) domain
+    cpu_id_t      package       ;
+    std::uint16_t numa_node     ; // index into numa_nodes() (0 without NUMA information)
+    std::uint16_t capacity      ; // 1-1024 (1024 for every CPU of a homogeneous/unknown machine)
+    std::uint8_t  capacity_class; // 0 = the biggest cores
+}; // struct cpu_info
+
+// The online CPUs in 'locality order': sorted by NUMA node, package, capacity
+// class, L3, cluster, L2, core and SMT thread - so that neighbours in the
+// sequence share the most cache and the biggest cores of a package come
+// first. Discovered once (on first use); empty where the platform offers no
+// topology information.
+std::span<cpu_info const> cpu_topology() noexcept;
+
+// The (uncached) discovery behind numa_nodes() and cpu_topology() done over
+// the given sysfs 'system' directory (normally /sys/devices/system) - e.g. a
+// captured or synthesized tree.
+std::vector<numa_node> read_numa_nodes  ( char const * system_dir );
+std::vector<cpu_info > read_cpu_topology( char const * system_dir );
+
+// The CPUs the process may currently run on (process_cpus(): the cpuset and
+// a narrower launch affinity - not any one thread's, which pinning may have
+// narrowed down), ascending. Re-read on every call; empty where unknown.
+std::vector<cpu_id_t> allowed_cpus();
+
+// The CPUs sharing the last level cache with the given one (its L3 domain,
+// or the L2 one where there is no L3), ascending. Restricted to the CPUs of
+// the same capacity class (on hybrid x86 P and E cores share the L3).
+std::vector<cpu_id_t> llc_domain_cpus( cpu_id_t cpu );
+
+// Lays `slots` consecutive slots (e.g. worker indices) out over `cpus` (in
+// locality order: slot i goes to cpus[ ( first + i ) % cpus.size() ]) and
+// yields, for each slot, the [begin, end) run of neighbouring slots placed
+// on the same NUMA node. Empty for an empty `cpus`.
+struct slot_range
+{
+    std::uint16_t begin;
+    std::uint16_t end  ;
+}; // struct slot_range
+std::vector<slot_range> numa_slot_ranges( std::span<cpu_info const> cpus, std::uint16_t slots, std::uint16_t first );
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// \file wait_helper.hpp
+/// ---------------------
+///
+/// (c) Copyright Domagoj Saric 2026.
+///
+///  Use, modification and distribution are subject to the
+///  Boost Software License, Version 1.0. (See accompanying file
+///  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+///
+///  See http://www.boost.org for most recent version.
+///
+////////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------------------
+#pragma once
+//------------------------------------------------------------------------------
+#include <cstdint>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+// A thread's way of making progress while it waits: a pool installs one on
+// each of its worker threads (for the lifetime of the thread) and thrd_lite's
+// opted-in blocking waits (future::wait_helping(), get_helping() and their
+// outcome_future counterparts - see there for the re-entrancy they imply)
+// keep calling it, instead of parking, for as long as it finds something to
+// run - a worker
+// waiting for an item it dispatched runs queued items (quite possibly the
+// awaited one) instead of idling a thread of an already saturated pool.
+// Scoped (installation restores the previous helper on destruction) and
+// reentrant (a helped item may wait, and so help, in turn) - up to
+// max_depth nested helps per thread: waits beyond it simply block (each
+// level holds a suspended item on the stack - the chain must not grow
+// without bound).
+class wait_helper
+{
+public:
+    // Runs (at most) a single item - returns whether it found one.
+    using help_t = bool ( void * context ) noexcept;
+
+    static constexpr std::uint8_t max_depth{ 4 };
+
+    wait_helper( help_t * const help, void * const context ) noexcept
+        : help_{ help }, context_{ context }, p_previous_{ p_active_ } { p_active_ = this; }
+    ~wait_helper() noexcept { p_active_ = p_previous_; }
+
+    wait_helper( wait_helper const & ) = delete;
+    wait_helper & operator=( wait_helper const & ) = delete;
+
+    // Helps (with the current thread's helper, if any) until done() or until
+    // there is nothing left to help with - the caller then proceeds to its
+    // actual (blocking) wait.
+    template <typename Done>
+    static void help_until( Done && done ) noexcept
+    {
+        auto const p_helper{ p_active_ };
+        if ( !p_helper || ( depth_ == max_depth ) )
+            return;
+        ++depth_;
+        while ( !done() && p_helper->help_( p_helper->context_ ) ) {}
+        --depth_;
+    }
+
+private:
+    help_t            * help_      ;
+    void              * context_   ;
+    wait_helper const * p_previous_;
+
+    static inline thread_local wait_helper const * p_active_{ nullptr };
+    static inline thread_local std::uint8_t        depth_   { 0       };
+}; // class wait_helper
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
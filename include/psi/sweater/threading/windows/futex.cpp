@@ -41,6 +41,10 @@ void futex::wait_if_equal( value_type const desired_value, value_type ) const no
     BOOST_VERIFY( ::WaitOnAddress( const_cast< futex * >( this ), const_cast< value_type * >( &desired_value ), sizeof( *this ), INFINITE ) );
 };
 
+// WaitOnAddress waits on a single address -- see futex.hpp.
+bool futex::has_wait_any() noexcept { return false; }
+void futex::wait_any_if_equal( value_type const desired_value, futex const &, value_type ) const noexcept { wait_if_equal( desired_value ); }
+
 //------------------------------------------------------------------------------
 } // namespace psi::thrd_lite
 //------------------------------------------------------------------------------
@@ -18,6 +18,9 @@
 #include <boost/assert.hpp>
 #include <psi/build/attributes.hpp>
 #include <windows.h>
+
+#include <cstddef>
+#include <iterator>
 //------------------------------------------------------------------------------
 namespace psi::thrd_lite
 {
@@ -70,6 +73,19 @@ public:
         return true;
     }
 
+    // Names the calling thread (for debuggers and profilers) - Windows 10
+    // 1607+ (SetThreadDescription). ASCII names are assumed (widened as is).
+    PSI_COLD
+    static bool set_active_thread_name( char const * const name ) noexcept
+    {
+        wchar_t wide_name[ 64 ];
+        std::size_t length{ 0 };
+        for ( ; name[ length ] && ( length < std::size( wide_name ) - 1 ); ++length )
+            wide_name[ length ] = static_cast<wchar_t>( static_cast<unsigned char>( name[ length ] ) );
+        wide_name[ length ] = L'\0';
+        return SUCCEEDED( ::SetThreadDescription( ::GetCurrentThread(), wide_name ) );
+    }
+
     class affinity_mask
     {
     public:
@@ -89,9 +105,9 @@ protected:
     thread_impl() = default;
    ~thread_impl() = default;
 
-    using thread_procedure = PTHREAD_START_ROUTINE; auto create( thread_procedure const start_routine, void * const arg ) noexcept
+    using thread_procedure = PTHREAD_START_ROUTINE; auto create( thread_procedure const start_routine, void * const arg, std::size_t const stack_size = 0 /*platform default*/ ) noexcept
     {
-        handle_ = ::CreateThread( nullptr, 0, start_routine, arg, 0, nullptr );
+        handle_ = ::CreateThread( nullptr, stack_size, start_routine, arg, stack_size ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0, nullptr );
         if ( PSI_UNLIKELY( handle_ == nullptr ) )
         {
             BOOST_ASSERT( ::GetLastError() == ERROR_NOT_ENOUGH_MEMORY ); // any other error indicates a programmer error
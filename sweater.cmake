@@ -71,6 +71,8 @@ option( PSI_SWEATER_OUTCOME_STANDALONE "When PSI_SWEATER_WITH_OUTCOME is ON: fet
 
 set( sources_threading
     ${src_root}/threading/barrier.hpp
+    ${src_root}/threading/eventcount.cpp
+    ${src_root}/threading/eventcount.hpp
     ${src_root}/threading/futex.hpp
     ${src_root}/threading/futex_barrier.cpp
     ${src_root}/threading/futex_barrier.hpp
@@ -82,12 +84,18 @@ set( sources_threading
     ${src_root}/threading/generic_semaphore.cpp
     ${src_root}/threading/hardware_concurrency.cpp
     ${src_root}/threading/hardware_concurrency.hpp
+    ${src_root}/threading/idle_stack.hpp
     ${src_root}/threading/condvar.hpp
     ${src_root}/threading/future.hpp
     ${src_root}/threading/mutex.hpp
+    ${src_root}/threading/phase_barrier.cpp
+    ${src_root}/threading/phase_barrier.hpp
     ${src_root}/threading/rw_mutex.hpp
     ${src_root}/threading/semaphore.hpp
     ${src_root}/threading/thread.hpp
+    ${src_root}/threading/topology.cpp
+    ${src_root}/threading/topology.hpp
+    ${src_root}/threading/wait_helper.hpp
 )
 if ( PSI_SWEATER_WITH_OUTCOME )
     list( APPEND sources_threading ${src_root}/threading/outcome_future.hpp )
@@ -115,6 +123,7 @@ endif()
 option( PSI_SWEATER_FORCE_CONDVAR_SEMAPHORE "Force the condvar-based semaphore (A/B knob)" OFF )
 if ( sweater_apple_embedded )
     set_source_files_properties( ${src_root}/threading/futex_barrier.cpp   PROPERTIES HEADER_FILE_ONLY ON )
+    set_source_files_properties( ${src_root}/threading/eventcount.cpp      PROPERTIES HEADER_FILE_ONLY ON ) # (no PSI_SWEATER_EVENTCOUNT_PARKING there)
 else()
     set_source_files_properties( ${src_root}/threading/generic_barrier.cpp PROPERTIES HEADER_FILE_ONLY ON )
 endif()
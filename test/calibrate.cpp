@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+/// Host calibration tool for the generic shop (sweater_calibrate).
+///
+/// Measures, on the machine it runs on:
+///   - the futex wake latency (semaphore ping-pong between two parked threads)
+///   - the duration of a spin loop iteration - and from the two the spin
+///     count at which spinning stops paying off against parking (spinning
+///     for about as long as a park+wake round trip costs: the classic
+///     2-competitive spin-then-park bound)
+///   - the per-item cost of single vs bulk enqueues (what slicing spread
+///     parts for stealing and queuing fires cost)
+///   - the iteration count at which a spread starts beating a serial loop
+///     (for a reference iteration of a given cost)
+/// and writes a profile (key=value lines) that shops load through
+/// shop::options::load_profile() or, for default constructed shops, the
+/// PSI_SWEATER_PROFILE environment variable.
+///
+/// Usage: sweater_calibrate [profile path (default: stdout only)]
+///                          [reference iteration cost in ns (default: 100)]
+/// Run on an idle machine (and with the CPU governor the deployment uses).
+////////////////////////////////////////////////////////////////////////////////
+#include <psi/sweater/impls/generic.hpp>
+#include <psi/sweater/threading/cpp/spin_lock.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <print>
+#include <thread>
+#include <vector>
+//------------------------------------------------------------------------------
+
+namespace
+{
+    using clk  = std::chrono::steady_clock;
+    using shop = psi::sweater::generic::shop;
+
+    double ns( clk::duration const d, std::uint64_t const per = 1 ) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::duration<double, std::nano>>( d ).count() / static_cast<double>( per );
+    }
+
+    template <typename F>
+    double median_ns( unsigned const repetitions, std::uint64_t const per, F && measured )
+    {
+        std::vector<double> samples( repetitions );
+        for ( auto & sample : samples )
+        {
+            auto const start{ clk::now() };
+            measured();
+            sample = ns( clk::now() - start, per );
+        }
+        std::nth_element( samples.begin(), samples.begin() + repetitions / 2, samples.end() );
+        return samples[ repetitions / 2 ];
+    }
+
+    // Signal-to-running latency of a parked thread (plain wait(), no
+    // spinning): the median over hand-offs to an echo thread given the time
+    // to park before each one.
+    double wake_latency_ns()
+    {
+        psi::thrd_lite::semaphore ping, pong;
+        auto constexpr rounds{ 1001U };
+        std::vector<clk::time_point> sent( rounds ), woken( rounds );
+        std::thread echo{ [ & ]() noexcept
+        {
+            for ( auto round{ 0U }; round < rounds; ++round )
+            {
+                ping.wait();
+                woken[ round ] = clk::now();
+                pong.signal();
+            }
+        } };
+        for ( auto round{ 0U }; round < rounds; ++round )
+        {
+            std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+            sent[ round ] = clk::now();
+            ping.signal();
+            pong.wait();
+        }
+        echo.join();
+        std::vector<double> latencies( rounds );
+        for ( auto round{ 0U }; round < rounds; ++round )
+            latencies[ round ] = ns( woken[ round ] - sent[ round ] );
+        std::nth_element( latencies.begin(), latencies.begin() + rounds / 2, latencies.end() );
+        return std::max( 1.0, latencies[ rounds / 2 ] );
+    }
+
+    // The semaphore/barrier spin loop iteration: nops( 8 ) and a load.
+    double spin_iteration_ns()
+    {
+        std::atomic<std::uint32_t> spun_on{ 0 };
+        auto constexpr iterations{ 1U << 16 };
+        return median_ns( 15, iterations, [ & ]() noexcept
+        {
+            for ( auto iteration{ 0U }; iteration < iterations; ++iteration )
+            {
+                psi::thrd_lite::nops( 8 );
+                (void)spun_on.load( std::memory_order_acquire );
+            }
+        } );
+    }
+
+    struct enqueue_costs { double single_ns, bulk_ns; };
+
+    enqueue_costs enqueue_costs_per_item()
+    {
+        psi::sweater::queues::mpmc_moodycamel<std::uint64_t> queue;
+        auto       token   { queue.producer_token() };
+        auto       consumer{ queue.consumer_token() };
+        auto constexpr items{ 16U };
+        std::uint64_t batch[ items ]{};
+        auto const drain{ [ & ]() noexcept { std::uint64_t item; while ( queue.dequeue( item, consumer ) ) {} } };
+        auto const single_ns{ median_ns( 2001, items, [ & ]
+        {
+            for ( auto const item : batch )
+                (void)queue.enqueue( item, token );
+            drain();
+        } ) };
+        auto const bulk_ns{ median_ns( 2001, items, [ & ]
+        {
+            (void)queue.enqueue_bulk( token, batch, items );
+            drain();
+        } ) };
+        return { single_ns, bulk_ns };
+    }
+
+    // A dependent integer chain of roughly the requested duration.
+    struct reference_iteration
+    {
+        std::uint32_t steps;
+
+        static std::uint64_t run( std::uint32_t const steps, std::uint64_t seed ) noexcept
+        {
+            for ( auto step{ 0U }; step < steps; ++step )
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            return seed;
+        }
+
+        explicit reference_iteration( double const target_ns )
+        {
+            std::atomic<std::uint64_t> sink{ 0 };
+            auto constexpr probe_steps{ 1U << 20 };
+            auto const step_ns{ median_ns( 7, probe_steps, [ & ]() noexcept { sink += run( probe_steps, sink ); } ) };
+            steps = static_cast<std::uint32_t>( std::max( 1.0, target_ns / step_ns ) );
+        }
+    }; // struct reference_iteration
+
+    // The smallest (power of two) iteration count for which the spread beats
+    // the serial loop.
+    shop::iterations_t spread_break_even( shop & work_shop, reference_iteration const iteration )
+    {
+        std::atomic<std::uint64_t> sink{ 0 };
+        for ( shop::iterations_t iterations{ 1 }; iterations < ( 1U << 20 ); iterations *= 2 )
+        {
+            auto const serial_ns{ median_ns( 31, 1, [ & ]() noexcept
+            {
+                std::uint64_t seed{ 0 };
+                for ( shop::iterations_t i{ 0 }; i < iterations; ++i )
+                    seed = reference_iteration::run( iteration.steps, seed + i );
+                sink += seed;
+            } ) };
+            auto const spread_ns{ median_ns( 31, 1, [ & ]() noexcept
+            {
+                work_shop.spread_the_sweat( iterations, [ & ]( shop::iterations_t const begin, shop::iterations_t const end ) noexcept
+                {
+                    std::uint64_t seed{ 0 };
+                    for ( auto i{ begin }; i < end; ++i )
+                        seed = reference_iteration::run( iteration.steps, seed + i );
+                    sink.fetch_add( seed, std::memory_order_relaxed );
+                } );
+            } ) };
+            if ( spread_ns < serial_ns )
+                return iterations;
+        }
+        return 1U << 20;
+    }
+
+    template <typename T>
+    T clamped( double const value, T const low, T const high ) noexcept
+    {
+        return static_cast<T>( std::clamp( value, static_cast<double>( low ), static_cast<double>( high ) ) );
+    }
+} // anonymous namespace
+
+int main( int const argc, char const * const argv[] )
+{
+    auto const profile_path     { argc > 1 ? argv[ 1 ] : nullptr };
+    auto const reference_cost_ns{ argc > 2 ? std::atof( argv[ 2 ] ) : 100.0 };
+
+    shop::options measuring_options; // (not from_environment(): measure the defaults)
+    shop work_shop{ std::move( measuring_options ) };
+    auto const workers{ work_shop.number_of_workers() };
+
+    auto const wake_ns { wake_latency_ns  () };
+    auto const spin_ns { spin_iteration_ns() };
+    auto const enqueues{ enqueue_costs_per_item() };
+    auto const break_even{ spread_break_even( work_shop, reference_iteration{ reference_cost_ns } ) };
+
+    std::println( "workers                 : {}", workers );
+    std::println( "wake latency            : {:8.1f} ns", wake_ns );
+    std::println( "spin iteration          : {:8.2f} ns", spin_ns );
+    std::println( "enqueue (single / bulk) : {:8.1f} / {:.1f} ns per item", enqueues.single_ns, enqueues.bulk_ns );
+    std::println( "spread break-even       : {} iterations of ~{} ns", break_even, reference_cost_ns );
+
+    // Spin for about a park+wake round trip; the caller's join spin (which
+    // yields rather than parks once it runs out) guards the spread's
+    // critical path - give it a longer window.
+    auto const worker_spin_count{ clamped<std::uint32_t>( 2 * wake_ns / spin_ns, 0, 1U << 20 ) };
+    auto const caller_spin_count{ clamped<std::uint32_t>( 8.0 * worker_spin_count, 0, 1U << 22 ) };
+    // Slicing a part into d slices costs d-1 extra (bulk) queue items: allow
+    // at most a wake latency worth of it.
+    auto const stealing_division_max{ clamped<unsigned>( wake_ns / std::max( enqueues.bulk_ns, 1.0 ), 2, shop::options::stealing_division_limit ) };
+    auto const stealing_division_min{ std::max( 1U, stealing_division_max / 4 ) };
+    // Keep piling fires onto an awake worker while the backlog costs less to
+    // queue than waking the next one.
+    auto const sticky_dispatch_depth{ clamped<unsigned>( wake_ns / std::max( 4 * enqueues.single_ns, 1.0 ), 1, 8 ) };
+    auto const min_parallel_grain   { std::max<shop::iterations_t>( 1, break_even / workers ) };
+
+    auto const write_profile{ [ & ]( std::FILE * const file )
+    {
+        std::println( file, "# sweater_calibrate profile ({} workers, reference iteration ~{} ns)", workers, reference_cost_ns );
+        std::println( file, "worker_spin_count     = {}", worker_spin_count     );
+        std::println( file, "caller_spin_count     = {}", caller_spin_count     );
+        std::println( file, "stealing_division_min = {}", stealing_division_min );
+        std::println( file, "stealing_division_max = {}", stealing_division_max );
+        std::println( file, "sticky_dispatch_depth = {}", sticky_dispatch_depth );
+        std::println( file, "min_parallel_grain    = {}", min_parallel_grain    );
+    } };
+    write_profile( stdout );
+    if ( profile_path )
+    {
+        auto const file{ std::fopen( profile_path, "w" ) };
+        if ( !file )
+        {
+            std::println( stderr, "cannot write {}", profile_path );
+            return EXIT_FAILURE;
+        }
+        write_profile( file );
+        std::fclose( file );
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+//==============================================================================
+// Low-level tests for psi::thrd_lite::eventcount (eventcount.hpp): the
+// prepare_wait/cancel_wait/commit_wait protocol of a consumer, the waiter
+// gated notify_one/notify_all of a producer and, as a stress test, the
+// missed-wakeup race between a consumer's condition re-check and a producer's
+// notification that the protocol exists to close.
+//==============================================================================
+
+#include <psi/sweater/threading/eventcount.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+namespace
+{
+    // Parks on the eventcount (unconditionally - no condition to re-check)
+    // until notified.
+    std::thread parked_waiter( eventcount & event, std::atomic<std::uint32_t> & parked, std::atomic<std::uint32_t> & woken )
+    {
+        return std::thread{ [ & ]
+        {
+            auto const key{ event.prepare_wait() };
+            parked.fetch_add( 1 );
+            event.commit_wait( key );
+            woken.fetch_add( 1 );
+        } };
+    }
+
+    void wait_until_parked( std::atomic<std::uint32_t> const & parked, std::uint32_t const count )
+    {
+        while ( parked.load() < count )
+            std::this_thread::yield();
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 50 } ); // let them actually park
+    }
+} // anonymous namespace
+
+TEST( Eventcount, NotifyWithoutWaitersLeavesTheEpoch )
+{
+    eventcount event;
+    auto const epoch{ event.epoch().load() };
+    event.notify_one();
+    event.notify_all();
+    EXPECT_EQ( event.epoch().load(), epoch ) << "the fast path (nobody prepared) must not touch the epoch";
+
+    // A cancelled wait unregisters the consumer.
+    (void)event.prepare_wait();
+    event.cancel_wait();
+    event.notify_one();
+    EXPECT_EQ( event.epoch().load(), epoch );
+}
+
+TEST( Eventcount, NotifyBetweenPrepareAndCommitIsNotMissed )
+{
+    eventcount event;
+    auto const key{ event.prepare_wait() };
+    event.notify_one(); // (the consumer's condition re-check would have raced this)
+    EXPECT_NE( event.epoch().load(), key );
+    event.commit_wait( key ); // must not park: the key predates the notification
+
+    auto parked{ false };
+    auto const stale_key{ event.prepare_wait() };
+    event.notify_all();
+    event.commit_wait( stale_key, [ & ]() noexcept { parked = true; } );
+    EXPECT_FALSE( parked ) << "commit_wait() ran the park hook with a stale key";
+}
+
+TEST( Eventcount, NotifyOneWakesOneParkedWaiter )
+{
+    eventcount event;
+    std::atomic<std::uint32_t> parked{ 0 }, woken{ 0 };
+    auto first { parked_waiter( event, parked, woken ) };
+    auto second{ parked_waiter( event, parked, woken ) };
+    wait_until_parked( parked, 2 );
+    EXPECT_EQ( woken.load(), 0U );
+
+    event.notify_one();
+    std::this_thread::sleep_for( std::chrono::milliseconds{ 100 } );
+    EXPECT_EQ( woken.load(), 1U );
+
+    event.notify_one();
+    first .join();
+    second.join();
+    EXPECT_EQ( woken.load(), 2U );
+}
+
+TEST( Eventcount, NotifyAllWakesEveryParkedWaiter )
+{
+    eventcount event;
+    std::atomic<std::uint32_t> parked{ 0 }, woken{ 0 };
+    std::vector<std::thread> waiters;
+    for ( auto waiter{ 0 }; waiter < 4; ++waiter )
+        waiters.push_back( parked_waiter( event, parked, woken ) );
+    wait_until_parked( parked, 4 );
+    EXPECT_EQ( woken.load(), 0U );
+
+    event.notify_all();
+    for ( auto & waiter : waiters )
+        waiter.join();
+    EXPECT_EQ( woken.load(), 4U );
+}
+
+// A consumer that checks a condition, prepares, re-checks and parks against
+// a producer that makes the condition true and notifies - one item at a time
+// so that every notification races a consumer on its way to park. A missed
+// wake-up leaves the consumer parked forever (i.e. hangs the test).
+TEST( Eventcount, ProducerConsumerHandoffsLoseNoWakeup )
+{
+    constexpr std::uint32_t items{ 20000 };
+    eventcount event;
+    std::atomic<std::uint32_t> produced{ 0 }, consumed{ 0 };
+
+    std::thread consumer{ [ & ]
+    {
+        while ( consumed.load( std::memory_order_relaxed ) < items )
+        {
+            if ( produced.load( std::memory_order_acquire ) > consumed.load( std::memory_order_relaxed ) )
+            {
+                consumed.fetch_add( 1, std::memory_order_release );
+                continue;
+            }
+            auto const key{ event.prepare_wait() };
+            if ( produced.load( std::memory_order_acquire ) > consumed.load( std::memory_order_relaxed ) )
+            {
+                event.cancel_wait();
+                continue;
+            }
+            event.commit_wait( key );
+        }
+    } };
+
+    for ( std::uint32_t item{ 0 }; item < items; ++item )
+    {
+        produced.fetch_add( 1, std::memory_order_release );
+        event.notify_one();
+        while ( consumed.load( std::memory_order_acquire ) <= item )
+            std::this_thread::yield();
+    }
+    consumer.join();
+    EXPECT_EQ( consumed.load(), items );
+}
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
@@ -4,7 +4,9 @@
 // Linux (FUTEX_WAIT_BITSET/FUTEX_WAKE_BITSET), a wake_all(bits) call only wakes
 // waiters that parked with a matching listen_bits; everywhere else the bitset
 // argument is a documented no-op and wake_all(bits) behaves exactly like plain
-// wake_all() (wakes every waiter on this word, regardless of bits).
+// wake_all() (wakes every waiter on this word, regardless of bits). Likewise
+// for wait_any_if_equal(): a real multi-wait on Linux 5.16+, a plain wait on
+// the first word elsewhere.
 //==============================================================================
 
 #include <psi/sweater/threading/futex.hpp>
@@ -76,6 +78,28 @@ TEST( Futex, WaitIfEqualDefaultBitsetStillWorks )
     EXPECT_TRUE( woken.load() );
 }
 
+TEST( Futex, WaitAnyWakesThroughEitherWord )
+{
+    // Where multi-wait exists (Linux 5.16+ futex_waitv) a wake of the OTHER
+    // word has to unpark the waiter; elsewhere wait_any_if_equal() is a plain
+    // wait on the first word (the documented fallback), so only that is
+    // exercised there.
+    futex own{ 0 }, shared{ 0 };
+    std::atomic<bool> woken{ false };
+    std::thread t{ [&] { own.wait_any_if_equal( 0, shared, 0 ); woken = true; } };
+    std::this_thread::sleep_for( std::chrono::milliseconds{ 50 } ); // let it park
+    EXPECT_FALSE( woken.load() );
+    if ( futex::has_wait_any() )
+    {
+        shared.wake_all();
+        std::this_thread::sleep_for( std::chrono::milliseconds{ 100 } );
+        EXPECT_TRUE( woken.load() ) << "a wake of the second word failed to unpark a wait_any_if_equal() waiter";
+    }
+    own.wake_all(); // (join() below must not hang on either outcome)
+    t.join();
+    EXPECT_TRUE( woken.load() );
+}
+
 //------------------------------------------------------------------------------
 } // namespace psi::thrd_lite
 //------------------------------------------------------------------------------
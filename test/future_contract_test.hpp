@@ -15,10 +15,13 @@
 //   template <typename T> static void expect_exception( future_type<T> & ); // asserts a failure state
 // promise_type<T> itself must expose set_value(Args&&...), set_exception(std::exception_ptr),
 // run(F&&) and wait() -- the shared surface thrd_lite::promise<T> and
-// thrd_lite::outcome_promise<T> already agree on.
+// thrd_lite::outcome_promise<T> already agree on -- and future_type<T> wait()
+// and wait_helping().
 //==============================================================================
 #pragma once
 
+#include <psi/sweater/threading/wait_helper.hpp>
+
 #include <gtest/gtest.h>
 
 #include <atomic>
@@ -133,13 +136,60 @@ TYPED_TEST_P( FutureContract, BrokenPromiseWhenDroppedIncomplete )
     TypeParam::expect_exception( pair.second );
 }
 
+// Only the opted-in wait_helping() runs the thread's wait_helper (a pool
+// worker's queued items - see wait_helper.hpp): plain waits, which cannot
+// know whether the caller is re-entrant, block.
+TYPED_TEST_P( FutureContract, OnlyHelpingWaitsRunTheWaitHelper )
+{
+    using promise_t = typename TypeParam::template promise_type<int>;
+    struct context_t
+    {
+        promise_t * p_pending; // the 'queued item' a help completes
+        int         helps    ;
+    }; // struct context_t
+
+    auto helped( TypeParam::template make<int>() );
+    context_t context{ &helped.first, 0 };
+    wait_helper const helper
+    {
+        []( void * const p_context ) noexcept
+        {
+            auto & context{ *static_cast<context_t *>( p_context ) };
+            ++context.helps;
+            if ( !context.p_pending )
+                return false;
+            context.p_pending->set_value( 1 );
+            context.p_pending = nullptr;
+            return true;
+        },
+        &context
+    };
+    helped.second.wait_helping();
+    EXPECT_EQ( context.helps, 1 );
+    EXPECT_EQ( TypeParam::get_value( helped.second ), 1 );
+
+    context.helps = 0;
+    auto plain( TypeParam::template make<int>() );
+    std::thread completer
+    {
+        [ promise = std::move( plain.first ) ]() mutable noexcept
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds{ 20 } );
+            promise.set_value( 2 );
+        }
+    };
+    EXPECT_EQ( TypeParam::get_value( plain.second ), 2 );
+    completer.join();
+    EXPECT_EQ( context.helps, 0 );
+}
+
 REGISTER_TYPED_TEST_SUITE_P
 (
     FutureContract,
     ValueSameThread, VoidValueSameThread, ExceptionSameThread,
     RunCapturesResult, RunCapturesException, WaitThenGet,
     DestructorWaitsForCompletion, CrossThreadHandoff, MoveOnlyValueType,
-    BrokenPromiseWhenDroppedIncomplete
+    BrokenPromiseWhenDroppedIncomplete, OnlyHelpingWaitsRunTheWaitHelper
 );
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,113 @@
+//==============================================================================
+// Tests for psi::thrd_lite::idle_stack (idle_stack.hpp), the lock-free LIFO
+// of idle threads behind the generic shop's most-recently-idled-first fire
+// wake-ups: the pop order, skipping of stale entries (owners woken by other
+// means) and, as a stress test, concurrent push/leave/pop churn after which
+// every entry has to be listed exactly once.
+//==============================================================================
+
+#include <psi/sweater/threading/idle_stack.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+namespace
+{
+    template <std::size_t size>
+    auto entries_of( std::array<idle_stack::entry, size> & entries ) noexcept
+    {
+        return [ & ]( idle_stack::index_t const index ) noexcept -> idle_stack::entry & { return entries[ index ]; };
+    }
+} // anonymous namespace
+
+TEST( IdleStack, PopsTheMostRecentlyIdledFirst )
+{
+    idle_stack stack;
+    std::array<idle_stack::entry, 4> entries;
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), idle_stack::none );
+
+    for ( idle_stack::index_t index : { 2, 0, 3 } )
+        stack.push( index, entries[ index ] );
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), 3U );
+    stack.push( 1, entries[ 1 ] );
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), 1U );
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), 0U );
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), 2U );
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), idle_stack::none );
+}
+
+TEST( IdleStack, SkipsStaleEntriesAndRefreshesListedOnes )
+{
+    idle_stack stack;
+    std::array<idle_stack::entry, 3> entries;
+    stack.push( 0, entries[ 0 ] );
+    stack.push( 1, entries[ 1 ] );
+    stack.push( 2, entries[ 2 ] );
+    entries[ 2 ].leave(); // woken by other means
+    entries[ 1 ].leave();
+    stack.push( 1, entries[ 1 ] ); // idle again while still listed: keeps its (older) position
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), 1U );
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), 0U );
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), idle_stack::none );
+
+    // Popped stale entries are unlisted (pushing them lists them anew).
+    stack.push( 2, entries[ 2 ] );
+    EXPECT_EQ( stack.pop( entries_of( entries ) ), 2U );
+}
+
+// Owners idling and getting woken (by a pop or by other means) concurrently
+// with poppers: pops must only ever return valid entries and, once the churn
+// quiesces and every owner idles, each entry has to come out exactly once
+// (no entry lost or listed twice by the racing listed/idle flags).
+TEST( IdleStack, ConcurrentChurnLosesAndDuplicatesNoEntry )
+{
+    constexpr idle_stack::index_t owners{ 8 };
+    constexpr std::uint32_t       rounds{ 20000 };
+    idle_stack stack;
+    std::array<idle_stack::entry, owners> entries;
+    std::atomic<std::uint32_t> invalid{ 0 };
+
+    std::vector<std::thread> threads;
+    for ( idle_stack::index_t owner{ 0 }; owner < owners; ++owner )
+    {
+        threads.emplace_back( [ &, owner ]
+        {
+            for ( std::uint32_t round{ 0 }; round < rounds; ++round )
+            {
+                stack.push( owner, entries[ owner ] );
+                if ( round % 3 == 0 )
+                    entries[ owner ].leave();
+                auto const popped{ stack.pop( entries_of( entries ) ) };
+                if ( ( popped != idle_stack::none ) && ( popped >= owners ) )
+                    invalid.fetch_add( 1, std::memory_order_relaxed );
+            }
+        } );
+    }
+    for ( auto & thread : threads )
+        thread.join();
+    EXPECT_EQ( invalid.load(), 0U );
+
+    for ( idle_stack::index_t owner{ 0 }; owner < owners; ++owner )
+        stack.push( owner, entries[ owner ] );
+    std::array<std::uint32_t, owners> popped{};
+    for ( auto index{ stack.pop( entries_of( entries ) ) }; index != idle_stack::none; index = stack.pop( entries_of( entries ) ) )
+    {
+        ASSERT_LT( index, owners );
+        ++popped[ index ];
+    }
+    for ( idle_stack::index_t owner{ 0 }; owner < owners; ++owner )
+        EXPECT_EQ( popped[ owner ], 1U ) << "entry " << owner;
+}
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
@@ -0,0 +1,142 @@
+//==============================================================================
+// Tests for psi::thrd_lite::phase_barrier (phase_barrier.hpp), the reusable
+// all-wait-for-all barrier behind shop::region::sync(): reuse over many
+// phases (no participant may run ahead into, or get stuck in, a phase), the
+// arrive_and_wait() result (exactly one last arrival per phase), visibility
+// of the work done before arriving and re-initialization between phases.
+// Typed over both the futex backed and the condvar based (the fallback of
+// platforms without a futex backend) variants so that the latter gets
+// exercised everywhere.
+//==============================================================================
+
+#include <psi/sweater/threading/phase_barrier.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+template <typename Barrier>
+class PhaseBarrier : public ::testing::Test {};
+
+using phase_barriers = ::testing::Types
+<
+#if PSI_THRD_LITE_HAS_FUTEX
+    futex_phase_barrier,
+#endif // PSI_THRD_LITE_HAS_FUTEX
+    generic_phase_barrier
+>;
+TYPED_TEST_SUITE( PhaseBarrier, phase_barriers );
+
+namespace
+{
+    // Runs body( participant, phase ) on each of the participants (the
+    // calling thread being participant 0), for each of the phases.
+    template <typename Body>
+    void run_phases( hardware_concurrency_t const participants, std::uint32_t const phases, Body && body )
+    {
+        std::vector<std::thread> threads;
+        for ( hardware_concurrency_t participant{ 1 }; participant < participants; ++participant )
+        {
+            threads.emplace_back( [ &, participant ]
+            {
+                for ( std::uint32_t phase{ 0 }; phase < phases; ++phase )
+                    body( participant, phase );
+            } );
+        }
+        for ( std::uint32_t phase{ 0 }; phase < phases; ++phase )
+            body( hardware_concurrency_t{ 0 }, phase );
+        for ( auto & thread : threads )
+            thread.join();
+    }
+} // anonymous namespace
+
+TYPED_TEST( PhaseBarrier, ASingleParticipantNeverWaits )
+{
+    TypeParam barrier{ 1 };
+    for ( std::uint32_t phase{ 0 }; phase < 3; ++phase )
+    {
+        EXPECT_EQ( barrier.phase(), phase );
+        EXPECT_TRUE( barrier.arrive_and_wait() );
+    }
+    EXPECT_EQ( barrier.phase(), 3U );
+}
+
+// Every participant writes its slot of the current phase's row and, after
+// the wait, checks everybody's: a participant running ahead (or a lost
+// wake-up, which hangs the test) shows up as a stale or missing slot. With
+// and without spinning (i.e. mostly parking).
+TYPED_TEST( PhaseBarrier, PhasesAreReusableAndOrderTheParticipantsWork )
+{
+    constexpr hardware_concurrency_t participants{ 4 };
+    constexpr std::uint32_t          phases      { 500 };
+    for ( std::uint32_t const spin_count : { 0U, 1000U } )
+    {
+        TypeParam barrier{ participants };
+        std::vector<std::uint32_t> slots( participants, 0 ); // (plain - ordered by the barrier)
+        std::atomic<std::uint32_t> last_arrivals{ 0 }, stale_reads{ 0 };
+
+        run_phases( participants, phases, [ & ]( hardware_concurrency_t const participant, std::uint32_t const phase )
+        {
+            slots[ participant ] = phase + 1;
+            if ( barrier.arrive_and_wait( spin_count ) )
+                last_arrivals.fetch_add( 1, std::memory_order_relaxed );
+            for ( auto const slot : slots )
+                if ( slot != phase + 1 )
+                    stale_reads.fetch_add( 1, std::memory_order_relaxed );
+            (void)barrier.arrive_and_wait( spin_count ); // (nobody overwrites its slot before everyone checked)
+        } );
+
+        EXPECT_EQ( last_arrivals.load(), phases ) << "spin count " << spin_count;
+        EXPECT_EQ( stale_reads  .load(), 0U     ) << "spin count " << spin_count;
+        EXPECT_EQ( barrier.phase(), 2 * phases  ) << "spin count " << spin_count;
+    }
+}
+
+// The last arrival of each phase is a single, arbitrary participant (the
+// result is what region::sync() style callers use to elect one of them for
+// serial work between two phases).
+TYPED_TEST( PhaseBarrier, ExactlyOneLastArrivalPerPhase )
+{
+    constexpr hardware_concurrency_t participants{ 3 };
+    constexpr std::uint32_t          phases      { 1000 };
+    TypeParam barrier{ participants };
+    std::vector<std::atomic<std::uint32_t>> last_arrivals( phases );
+
+    run_phases( participants, phases, [ & ]( hardware_concurrency_t, std::uint32_t const phase )
+    {
+        if ( barrier.arrive_and_wait( 100 ) )
+            last_arrivals[ phase ].fetch_add( 1, std::memory_order_relaxed );
+    } );
+
+    for ( std::uint32_t phase{ 0 }; phase < phases; ++phase )
+        EXPECT_EQ( last_arrivals[ phase ].load(), 1U ) << "phase " << phase;
+}
+
+TYPED_TEST( PhaseBarrier, ReinitializesBetweenPhases )
+{
+    TypeParam barrier{ 2 };
+    run_phases( 2, 10, [ & ]( hardware_concurrency_t, std::uint32_t ) { (void)barrier.arrive_and_wait(); } );
+    EXPECT_EQ( barrier.phase(), 10U );
+
+    barrier.initialize( 3 );
+    EXPECT_EQ( barrier.participants(), 3U );
+    std::atomic<std::uint32_t> last_arrivals{ 0 };
+    run_phases( 3, 10, [ & ]( hardware_concurrency_t, std::uint32_t )
+    {
+        if ( barrier.arrive_and_wait() )
+            last_arrivals.fetch_add( 1, std::memory_order_relaxed );
+    } );
+    EXPECT_EQ( last_arrivals.load(), 10U );
+    EXPECT_EQ( barrier.phase(), 20U );
+}
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------
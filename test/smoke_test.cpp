@@ -1,12 +1,48 @@
 #include <psi/sweater/sweater.hpp>
+#include <psi/sweater/threading/topology.hpp>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <type_traits>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif // __linux__
+
+namespace
+{
+    // The common spread test body: sums up the iterations it gets run over
+    // (which adds up to of( iterations ) only if every one of them was run
+    // exactly once).
+    class iteration_sum
+    {
+    public:
+        auto adder() noexcept
+        {
+            return [ this ]( std::uint32_t const begin, std::uint32_t const end ) noexcept
+            {
+                for ( auto i{ begin }; i < end; ++i )
+                    total_.fetch_add( i, std::memory_order_relaxed );
+            };
+        }
+
+        std::uint32_t total() const noexcept { return total_.load( std::memory_order_acquire ); }
+
+        static constexpr std::uint32_t of( std::uint32_t const iterations ) noexcept { return iterations * ( iterations - 1 ) / 2; }
+
+    private:
+        std::atomic<std::uint32_t> total_{ 0 };
+    }; // class iteration_sum
+} // anonymous namespace
 
 TEST( SweaterSmoke, SpreadTheSweat )
 {
@@ -22,6 +58,36 @@ TEST( SweaterSmoke, SpreadTheSweat )
     EXPECT_EQ( sum.load(), 1000 );
 }
 
+// Every element constructed exactly once and nothing around the range touched
+// (the probe counts the constructions per slot of its backing storage).
+namespace
+{
+    struct first_touch_probe
+    {
+        first_touch_probe() noexcept { hits[ this - storage ].fetch_add( 1, std::memory_order_relaxed ); }
+
+        static inline first_touch_probe        * storage;
+        static inline std::atomic<std::uint8_t> * hits   ;
+    }; // struct first_touch_probe
+} // anonymous namespace
+
+TEST( SweaterSmoke, SpreadFirstTouchConstructsEveryElementOnce )
+{
+    psi::sweater::shop work_shop;
+    for ( std::uint32_t const count : { 1U, 3U, 1000U, 65537U } )
+    {
+        std::vector<std::atomic<std::uint8_t>> hits( count + 2 );
+        auto const storage{ std::make_unique<std::byte[]>( ( count + 2 ) * sizeof( first_touch_probe ) ) };
+        first_touch_probe::storage = reinterpret_cast<first_touch_probe *>( storage.get() );
+        first_touch_probe::hits    = hits.data();
+        EXPECT_TRUE( work_shop.spread_first_touch( first_touch_probe::storage + 1, count ) );
+        EXPECT_EQ( hits.front().load(), 0 ) << count;
+        EXPECT_EQ( hits.back ().load(), 0 ) << count;
+        for ( std::uint32_t i{ 1 }; i <= count; ++i )
+            ASSERT_EQ( hits[ i ].load(), 1 ) << "element " << ( i - 1 ) << " of " << count;
+    }
+}
+
 TEST( SweaterSmoke, DispatchReturnsValue )
 {
     psi::sweater::shop work_shop;
@@ -82,3 +148,825 @@ TEST( SweaterSmoke, FireAndForgetRunsWork )
     }
     EXPECT_TRUE( done.load() );
 }
+
+#if PSI_SWEATER_EXACT_WORKER_SELECTION
+// Fire items wake the most recently idled worker (see shop::push_idle()): a
+// worker that just finished an item (and went idle last) gets the next one
+// too, rather than one of the longer parked workers.
+TEST( SweaterSmoke, FireWakesTheMostRecentlyIdledWorker )
+{
+    psi::sweater::shop work_shop;
+    if ( psi::thrd_lite::slow_thread_signals || ( work_shop.number_of_workers() < 2 ) )
+        GTEST_SKIP() << "needs at least two worker threads (and targeted wake-ups)";
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) ); // let the whole pool go idle
+    std::thread::id previous;
+    for ( auto round{ 0 }; round < 8; ++round )
+    {
+        std::atomic<bool> done{ false };
+        std::thread::id   runner;
+        (void)work_shop.fire_and_forget( [ & ]() noexcept
+        {
+            runner = std::this_thread::get_id();
+            done.store( true, std::memory_order_release );
+        } );
+        while ( !done.load( std::memory_order_acquire ) )
+            std::this_thread::yield();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) ); // let the runner go idle (last)
+        if ( round )
+            EXPECT_EQ( runner, previous ) << "round " << round;
+        previous = runner;
+    }
+}
+#endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+
+TEST( SweaterSmoke, FireStormsFromInsideAndOutsideThePool )
+{
+    // Items fired by the caller and, in turn, by the items themselves (from
+    // worker threads - the own-slot dispatch path) with the pool alternating
+    // between busy and parked.
+    psi::sweater::shop work_shop;
+    constexpr auto items{ 256 };
+    for ( auto round{ 0 }; round < 8; ++round )
+    {
+        std::atomic<int> done{ 0 };
+        for ( auto item{ 0 }; item < items; ++item )
+        {
+            work_shop.fire_and_forget( [&]() noexcept
+            {
+                work_shop.fire_and_forget( [&]() noexcept { done.fetch_add( 1, std::memory_order_release ); } );
+            } );
+        }
+        auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds( 5 ) };
+        while ( done.load( std::memory_order_acquire ) != items && std::chrono::steady_clock::now() < deadline )
+            std::this_thread::yield();
+        EXPECT_EQ( done.load(), items );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+    }
+}
+
+TEST( SweaterSmoke, WorkItemCountDrainsToZero )
+{
+    // Items added and completed on different shards (fired from the caller
+    // and from within the pool, run by whichever worker) still balance out.
+    psi::sweater::shop work_shop;
+    std::atomic<int> done{ 0 };
+    for ( auto item{ 0 }; item < 64; ++item )
+    {
+        work_shop.fire_and_forget( [&]() noexcept
+        {
+            work_shop.fire_and_forget( [&]() noexcept { done.fetch_add( 1, std::memory_order_release ); } );
+        } );
+    }
+    work_shop.spread_the_sweat( 1000, []( auto, auto ) noexcept {} );
+    auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds( 5 ) };
+    while ( ( done.load( std::memory_order_acquire ) != 64 || work_shop.number_of_items() != 0 ) && std::chrono::steady_clock::now() < deadline )
+        std::this_thread::yield();
+    EXPECT_EQ( done.load(), 64 );
+    EXPECT_EQ( work_shop.number_of_items(), 0 );
+}
+
+TEST( SweaterSmoke, SpreadsOvertakeAFireBacklog )
+{
+    psi::sweater::shop work_shop;
+    auto const backlog{ 50 * static_cast<int>( work_shop.number_of_workers() ) };
+    std::atomic<int> done{ 0 };
+    for ( auto item{ 0 }; item < backlog; ++item )
+    {
+        work_shop.fire_and_forget( [&]() noexcept
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+            done.fetch_add( 1, std::memory_order_release );
+        } );
+    }
+    iteration_sum sum;
+    work_shop.spread_the_sweat( 1000, sum.adder() );
+    EXPECT_EQ( sum.total(), iteration_sum::of( 1000 ) );
+    EXPECT_LT( done.load(), backlog ) << "the spread waited for the whole fire backlog";
+
+    auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds( 30 ) };
+    while ( done.load( std::memory_order_acquire ) != backlog && std::chrono::steady_clock::now() < deadline )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    EXPECT_EQ( done.load(), backlog );
+}
+
+TEST( SweaterSmoke, FireBacklogDoesNotHoldUpSpreadCompletions )
+{
+    psi::sweater::shop work_shop;
+    auto const backlog{ 200 * static_cast<int>( work_shop.number_of_workers() ) };
+    std::atomic<int> done{ 0 };
+    for ( auto item{ 0 }; item < backlog; ++item )
+    {
+        work_shop.fire_and_forget( [&]() noexcept
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+            done.fetch_add( 1, std::memory_order_release );
+        } );
+    }
+    // Slices long enough for the workers to get to some of them (between
+    // their fire items).
+    for ( auto spread{ 0 }; spread < 4; ++spread )
+        work_shop.spread_the_sweat( 1000, []( auto, auto ) noexcept { std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) ); } );
+
+    // Once the workers are back in the backlog the spread count has to be
+    // down to zero - long before the backlog is.
+    auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds( 30 ) };
+    while ( work_shop.number_of_spread_items() != 0 && done.load( std::memory_order_acquire ) != backlog && std::chrono::steady_clock::now() < deadline )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    EXPECT_LT( done.load(), backlog );
+    EXPECT_EQ( work_shop.number_of_spread_items(), 0 );
+
+    while ( done.load( std::memory_order_acquire ) != backlog && std::chrono::steady_clock::now() < deadline )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    EXPECT_EQ( done.load(), backlog );
+}
+
+TEST( SweaterSmoke, WorkersWaitingOnFuturesRunQueuedItems )
+{
+    psi::sweater::shop work_shop;
+    auto const workers{ static_cast<int>( work_shop.number_of_workers() ) - PSI_SWEATER_USE_CALLER_THREAD };
+    std::atomic<int> started{ 0 };
+    std::atomic<int> done   { 0 };
+    auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds( 30 ) };
+    // Every worker waits for a child it dispatched only once all of them
+    // hold a parent: parked (plain get()) waits would leave no thread to run
+    // the children.
+    for ( auto parent{ 0 }; parent < workers; ++parent )
+    {
+        work_shop.fire_and_forget( [&]() noexcept
+        {
+            started.fetch_add( 1, std::memory_order_relaxed );
+            while ( started.load( std::memory_order_relaxed ) != workers && std::chrono::steady_clock::now() < deadline )
+                std::this_thread::yield();
+            auto child{ work_shop.dispatch_lite( []() noexcept -> int { return 1; } ) };
+            done.fetch_add( child.get_helping(), std::memory_order_release );
+        } );
+    }
+    while ( done.load( std::memory_order_acquire ) != workers && std::chrono::steady_clock::now() < deadline )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    EXPECT_EQ( done.load(), workers );
+}
+
+TEST( SweaterSmoke, HelpingWaitsNestOnlyUpToMaxDepth )
+{
+    psi::sweater::shop work_shop;
+    auto const workers{ static_cast<int>( work_shop.number_of_workers() ) - PSI_SWEATER_USE_CALLER_THREAD };
+    if ( workers < 2 )
+        GTEST_SKIP() << "a chain longer than the nesting bound needs a second worker";
+    // A chain of dispatches, each waiting for the next: a worker takes at
+    // most the bound's worth of them onto its stack (through helping), the
+    // rest has to be left to the other workers.
+    constexpr auto max_levels{ psi::thrd_lite::wait_helper::max_depth + 1 };
+    struct chain
+    {
+        psi::sweater::shop           & shop;
+        std::vector<std::thread::id> & levels;
+
+        void operator()( std::size_t const level ) const noexcept
+        {
+            levels[ level ] = std::this_thread::get_id();
+            if ( level + 1 < levels.size() )
+                shop.dispatch_lite( [ this, level ]() noexcept { ( *this )( level + 1 ); } ).get_helping();
+        }
+    }; // struct chain
+    std::vector<std::thread::id> levels( max_levels + 1 );
+    chain const links{ work_shop, levels };
+    work_shop.dispatch_lite( [ & ]() noexcept { links( 0 ); } ).get();
+    for ( auto const & thread : levels )
+        EXPECT_LE( std::count( levels.begin(), levels.end(), thread ), max_levels );
+}
+
+TEST( SweaterSmoke, SpreadAsyncCompletesInTheBackground )
+{
+    psi::sweater::shop work_shop;
+    iteration_sum sum;
+    auto const add{ sum.adder() };
+
+    auto done{ work_shop.spread_async( 1000, add ) };
+    done.get();
+    EXPECT_EQ( sum.total(), iteration_sum::of( 1000 ) );
+
+    std::atomic<int> completions{ 0 };
+    for ( auto const iterations : { 0U, 1U, 1000U } )
+        (void)work_shop.spread_async( iterations, add, [&]() noexcept { completions.fetch_add( 1, std::memory_order_release ); } );
+    auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds( 30 ) };
+    while ( completions.load( std::memory_order_acquire ) != 3 && std::chrono::steady_clock::now() < deadline )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    EXPECT_EQ( completions.load(), 3 );
+    EXPECT_EQ( sum.total(), 2 * iteration_sum::of( 1000 ) );
+}
+
+TEST( SweaterSmoke, SpreadManyRunsEveryLoopOnce )
+{
+    psi::sweater::shop work_shop;
+    std::vector<std::atomic<int>> a( 1000 ), b( 3 ), c( 257 );
+    auto const touch{ []( std::vector<std::atomic<int>> & counters )
+    {
+        return [ & ]( std::uint32_t const begin, std::uint32_t const end ) noexcept
+        {
+            for ( auto i{ begin }; i < end; ++i )
+                counters[ i ].fetch_add( 1, std::memory_order_relaxed );
+        };
+    } };
+    auto const touch_a{ touch( a ) };
+    work_shop.spread_many( { { 1000, touch_a }, { 0, touch_a }, { 3, touch( b ) }, { 257, touch( c ) } } );
+    for ( auto const * const p_counters : { &a, &b, &c } )
+    {
+        for ( auto const & counter : *p_counters )
+            EXPECT_EQ( counter.load(), 1 );
+    }
+}
+
+TEST( SweaterSmoke, SpreadManySkipsEmptyLoops )
+{
+    psi::sweater::shop work_shop;
+    std::atomic<int> empty_calls{ 0 };
+    auto const never_empty{ [ & ]( std::uint32_t const begin, std::uint32_t const end ) noexcept
+    {
+        if ( begin >= end )
+            empty_calls.fetch_add( 1, std::memory_order_relaxed );
+    } };
+    iteration_sum sum;
+    auto const add{ sum.adder() };
+    // Empty loops first, last, between and at (likely) chunk boundaries.
+    work_shop.spread_many( { { 0, never_empty }, { 1, add }, { 0, never_empty }, { 0, never_empty }, { 1000, add }, { 0, never_empty } } );
+    work_shop.spread_many( { { 0, never_empty }, { 0, never_empty } } );
+    EXPECT_EQ( empty_calls.load(), 0 );
+    EXPECT_EQ( sum.total(), iteration_sum::of( 1 ) + iteration_sum::of( 1000 ) );
+}
+
+TEST( SweaterSmoke, StickySpreadCoversEveryIterationOnEveryPass )
+{
+    psi::sweater::shop work_shop;
+    psi::sweater::shop::affinity_partitioner partitioner;
+    for ( std::uint32_t const iterations : { 10000U, 10000U, 10000U, 777U, 3U, 10000U } )
+    {
+        std::vector<std::atomic<std::uint8_t>> visits( iterations );
+        work_shop.spread_the_sweat
+        (
+            partitioner,
+            iterations,
+            [ & ]( std::uint32_t const begin, std::uint32_t const end ) noexcept
+            {
+                for ( auto i{ begin }; i < end; ++i )
+                    visits[ i ].fetch_add( 1, std::memory_order_relaxed );
+            }
+        );
+        for ( auto const & visit : visits )
+            ASSERT_EQ( visit.load(), 1 );
+    }
+}
+
+#if PSI_SWEATER_TRACK_CPU_LIMITS
+// The recorded slice owners outlive a shrink of the active pool (a lower
+// CPU limit): the replay has to move the ones that are no longer
+// active. A part whose slices get stolen around (so that owners other than
+// the first worker get recorded) and the same shape before and after the
+// shrink (so that the layout gets replayed rather than redone).
+TEST( SweaterSmoke, StickySpreadsSurviveAPoolShrink )
+{
+    psi::sweater::shop work_shop;
+    if ( work_shop.number_of_active_workers() < 3 )
+        GTEST_SKIP() << "needs at least two active worker threads";
+
+    psi::sweater::shop::affinity_partitioner partitioner;
+    auto const pass{ [ & ]
+    {
+        std::vector<std::atomic<std::uint8_t>> visits( 1000 );
+        work_shop.spread_the_sweat
+        (
+            partitioner,
+            1000,
+            [ & ]( std::uint32_t const begin, std::uint32_t const end ) noexcept
+            {
+                std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+                for ( auto i{ begin }; i < end; ++i )
+                    visits[ i ].fetch_add( 1, std::memory_order_relaxed );
+            },
+            500 // (two parts: the caller's and one worker's, whatever the pool size)
+        );
+        for ( auto const & visit : visits )
+            ASSERT_EQ( visit.load(), 1 );
+    } };
+    for ( auto round{ 0 }; round < 4; ++round )
+        pass();
+
+    work_shop.limit_cpus( 2 );
+    EXPECT_EQ( work_shop.number_of_active_workers(), 2 );
+    for ( auto round{ 0 }; round < 4; ++round )
+        pass();
+
+    work_shop.limit_cpus( 0 );
+    EXPECT_GT( work_shop.number_of_active_workers(), 2 );
+    pass();
+}
+#endif // PSI_SWEATER_TRACK_CPU_LIMITS
+
+TEST( SweaterSmoke, ParallelRegionPhasesSeeEachOthersWork )
+{
+    psi::sweater::shop work_shop;
+    constexpr std::uint32_t phases{ 200 };
+    std::vector<std::atomic<std::uint32_t>> progress( work_shop.number_of_workers() + 1 );
+    std::atomic<std::uint32_t> singles{ 0 }, masters{ 0 }, stale{ 0 }, team_size{ 0 };
+    work_shop.parallel_region
+    (
+        [ & ]( auto const participant, psi::sweater::shop::region & team ) noexcept
+        {
+            team_size.store( team.size(), std::memory_order_relaxed );
+            for ( std::uint32_t phase{ 1 }; phase <= phases; ++phase )
+            {
+                progress[ participant ].store( phase, std::memory_order_relaxed );
+                team.sync();
+                for ( auto member{ 0U }; member < team.size(); ++member )
+                    if ( progress[ member ].load( std::memory_order_relaxed ) < phase )
+                        stale.fetch_add( 1, std::memory_order_relaxed );
+                team.single( [ & ]() noexcept { singles.fetch_add( 1, std::memory_order_relaxed ); } );
+                team.master( participant, [ & ]() noexcept { masters.fetch_add( 1, std::memory_order_relaxed ); } );
+            }
+        }
+    );
+    EXPECT_GE( team_size.load(), 1U );
+    EXPECT_EQ( stale  .load(), 0U     );
+    EXPECT_EQ( singles.load(), phases );
+    EXPECT_EQ( masters.load(), phases );
+}
+
+TEST( SweaterSmoke, ParallelRegionLeavesOutBusyWorkers )
+{
+    psi::sweater::shop work_shop;
+    if ( work_shop.number_of_workers() < 1U + PSI_SWEATER_USE_CALLER_THREAD )
+        GTEST_SKIP() << "needs a worker thread";
+
+    // A worker stuck in a fire item until the regions are over: a member
+    // queued behind it would stall its team until the item gives up.
+    std::atomic<bool> blocking{ false }, regions_done{ false }, gave_up{ false }, finished{ false };
+    work_shop.fire_and_forget( [ & ]() noexcept
+    {
+        blocking.store( true, std::memory_order_release );
+        auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds( 10 ) };
+        while ( !regions_done.load( std::memory_order_acquire ) )
+        {
+            if ( std::chrono::steady_clock::now() > deadline )
+            {
+                gave_up.store( true, std::memory_order_relaxed );
+                break;
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+        finished.store( true, std::memory_order_release );
+    } );
+    while ( !blocking.load( std::memory_order_acquire ) )
+        std::this_thread::yield();
+
+    for ( auto round{ 0 }; round < 8; ++round )
+    {
+        std::atomic<std::uint32_t> arrivals{ 0 };
+        std::uint32_t team_size{ 0 };
+        work_shop.parallel_region
+        (
+            [ & ]( auto const participant, psi::sweater::shop::region & team ) noexcept
+            {
+                team.master( participant, [ & ]() noexcept { team_size = team.size(); } );
+                for ( auto phase{ 0 }; phase < 10; ++phase )
+                {
+                    arrivals.fetch_add( 1, std::memory_order_relaxed );
+                    team.sync();
+                }
+            }
+        );
+        EXPECT_EQ( arrivals.load(), 10 * team_size );
+        EXPECT_LT( team_size, work_shop.number_of_workers() + !PSI_SWEATER_USE_CALLER_THREAD ) << "the busy worker got counted in";
+    }
+    regions_done.store( true, std::memory_order_release );
+    while ( !finished.load( std::memory_order_acquire ) )
+        std::this_thread::yield();
+    EXPECT_FALSE( gave_up.load() ) << "a region waited for the busy worker";
+}
+
+// Spreads issued by the participants (and unrelated ones from outside the
+// team) run alongside the region: their joins take queued slices but must
+// never take (and nest) a member of the team, which would then wait in
+// sync() for the very participant it got nested in.
+TEST( SweaterSmoke, ParallelRegionParticipantsCanSpread )
+{
+    psi::sweater::shop work_shop;
+    std::atomic<std::uint32_t> wrong_sums{ 0 };
+    std::atomic<bool> regions_done{ false };
+    std::thread outsider{ [ & ]
+    {
+        while ( !regions_done.load( std::memory_order_acquire ) )
+        {
+            iteration_sum sum;
+            work_shop.spread_the_sweat( 1000, sum.adder() );
+            if ( sum.total() != iteration_sum::of( 1000 ) )
+                wrong_sums.fetch_add( 1, std::memory_order_relaxed );
+        }
+    } };
+
+    for ( auto round{ 0 }; round < 16; ++round )
+    {
+        work_shop.parallel_region
+        (
+            [ & ]( auto, psi::sweater::shop::region & team ) noexcept
+            {
+                for ( auto phase{ 0 }; phase < 4; ++phase )
+                {
+                    iteration_sum sum;
+                    work_shop.spread_the_sweat( 1000, sum.adder() );
+                    if ( sum.total() != iteration_sum::of( 1000 ) )
+                        wrong_sums.fetch_add( 1, std::memory_order_relaxed );
+                    team.sync();
+                }
+            }
+        );
+    }
+    regions_done.store( true, std::memory_order_release );
+    outsider.join();
+    EXPECT_EQ( wrong_sums.load(), 0U );
+}
+
+// Stages (and loops) take only noexcept ( begin, end ) bodies - and copy
+// each other (rather than wrap a reference to one another).
+static_assert( !std::is_constructible_v<psi::sweater::shop::stage, int> );
+static_assert( !std::is_constructible_v<psi::sweater::shop::stage, void (*)( std::uint32_t, std::uint32_t )> );
+static_assert(  std::is_constructible_v<psi::sweater::shop::stage, void (*)( std::uint32_t, std::uint32_t ) noexcept> );
+static_assert( !std::is_constructible_v<psi::sweater::shop::loop, std::uint32_t, int> );
+static_assert(  std::is_trivially_constructible_v<psi::sweater::shop::stage, psi::sweater::shop::stage &> );
+
+TEST( SweaterSmoke, SpreadChainRunsStagesInOrderPerRange )
+{
+    psi::sweater::shop work_shop;
+    std::vector<std::uint32_t> first( 10000 ), second( 10000 );
+    std::atomic<int> out_of_order{ 0 };
+    work_shop.spread_chain
+    (
+        10000,
+        {
+            [ & ]( std::uint32_t const begin, std::uint32_t const end ) noexcept
+            {
+                for ( auto i{ begin }; i < end; ++i )
+                    first[ i ] = i + 1;
+            },
+            [ & ]( std::uint32_t const begin, std::uint32_t const end ) noexcept
+            {
+                for ( auto i{ begin }; i < end; ++i )
+                {
+                    if ( first[ i ] != i + 1 )
+                        out_of_order.fetch_add( 1, std::memory_order_relaxed );
+                    second[ i ] = first[ i ] * 2;
+                }
+            }
+        }
+    );
+    EXPECT_EQ( out_of_order.load(), 0 );
+    for ( std::uint32_t i{ 0 }; i < second.size(); ++i )
+        ASSERT_EQ( second[ i ], 2 * ( i + 1 ) );
+}
+
+#if PSI_SWEATER_HAS_BLOCKING_REGION
+TEST( SweaterSmoke, BlockingRegionCompensatesBlockedWorkers )
+{
+    psi::sweater::shop work_shop;
+    auto const workers{ static_cast<int>( work_shop.number_of_workers() ) - PSI_SWEATER_USE_CALLER_THREAD };
+    std::atomic<bool> release{ false };
+    std::atomic<int > blocked{ 0 };
+    // Block every worker (or the spare serving its slot) inside a
+    // blocking_region: without compensation the pool is left with no thread
+    // to run the final item until the release.
+    for ( auto item{ 0 }; item < workers; ++item )
+    {
+        work_shop.fire_and_forget( [&]() noexcept
+        {
+            work_shop.blocking( [&]() noexcept
+            {
+                blocked.fetch_add( 1, std::memory_order_relaxed );
+                while ( !release.load( std::memory_order_acquire ) )
+                    std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+            } );
+        } );
+    }
+    auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds( 5 ) };
+    while ( blocked.load( std::memory_order_relaxed ) != workers && std::chrono::steady_clock::now() < deadline )
+        std::this_thread::yield();
+    EXPECT_EQ( blocked.load(), workers );
+
+    std::atomic<bool> done{ false };
+    work_shop.fire_and_forget( [&]() noexcept { done.store( true, std::memory_order_release ); } );
+    while ( !done.load( std::memory_order_acquire ) && std::chrono::steady_clock::now() < deadline )
+        std::this_thread::yield();
+    EXPECT_TRUE( done.load() );
+
+    release.store( true, std::memory_order_release );
+}
+#endif // PSI_SWEATER_HAS_BLOCKING_REGION
+
+#if PSI_SWEATER_HAS_SHOP_OPTIONS
+TEST( SweaterSmoke, ShopsCarryTheirOwnOptions )
+{
+    using shop = psi::sweater::shop;
+    if ( psi::thrd_lite::get_hardware_concurrency_max() < 3 )
+        GTEST_SKIP() << "options::threads is capped by the hardware";
+    shop::options latency_options;
+    latency_options.threads               = 2;
+    latency_options.stealing_division_min = 1;
+    latency_options.stealing_division_max = 1;
+    latency_options.thread_name_prefix    = "latency";
+    latency_options.stack_size            = 256 * 1024;
+    shop::options throughput_options;
+    throughput_options.threads               = 3;
+    throughput_options.stealing_division_min = 8;
+    throughput_options.stealing_division_max = 16;
+    shop latency_shop   { std::move( latency_options    ) };
+    shop throughput_shop{ std::move( throughput_options ) };
+    EXPECT_EQ( latency_shop   .number_of_workers(), 2 );
+    EXPECT_EQ( throughput_shop.number_of_workers(), 3 );
+    EXPECT_EQ( latency_shop   .configuration().stealing_division_max,  1 );
+    EXPECT_EQ( throughput_shop.configuration().stealing_division_min,  8 );
+
+    for ( auto * const p_shop : { &latency_shop, &throughput_shop } )
+    {
+        iteration_sum sum;
+        p_shop->spread_the_sweat( 1000, sum.adder() );
+        EXPECT_EQ( sum.total(), iteration_sum::of( 1000 ) );
+    }
+
+#ifdef __linux__
+    auto const worker_name{ latency_shop.dispatch_lite( []() noexcept
+    {
+        char name[ 16 ]{};
+        pthread_getname_np( pthread_self(), name, sizeof( name ) );
+        return std::string{ name };
+    } ).get() };
+#   if PSI_SWEATER_EXACT_WORKER_SELECTION
+    EXPECT_EQ( worker_name, "latency0" );
+#   else
+    EXPECT_EQ( worker_name, "latency" ); // (workers have no index to append)
+#   endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+#endif // __linux__
+}
+
+TEST( SweaterSmoke, SpreadAsyncCompletesWithoutWorkerThreads )
+{
+    using shop = psi::sweater::shop;
+    shop::options single_thread_options;
+    single_thread_options.threads = 1;
+    shop work_shop{ std::move( single_thread_options ) };
+
+    // (Performed synchronously - otherwise nobody would ever run it.)
+    iteration_sum sum;
+    std::atomic<bool> completed{ false };
+    EXPECT_TRUE( work_shop.spread_async( 1000, sum.adder(), [&]() noexcept { completed.store( true, std::memory_order_release ); } ) );
+    ASSERT_TRUE( completed.load( std::memory_order_acquire ) );
+    EXPECT_EQ( sum.total(), iteration_sum::of( 1000 ) );
+
+    work_shop.spread_async( 1000, sum.adder() ).get();
+    EXPECT_EQ( sum.total(), 2 * iteration_sum::of( 1000 ) );
+}
+
+TEST( SweaterSmoke, OptionsLoadCalibrationProfiles )
+{
+    using shop = psi::sweater::shop;
+    auto const profile_path{ "sweater_smoke_test.profile" };
+    {
+        auto const file{ std::fopen( profile_path, "w" ) };
+        ASSERT_NE( file, nullptr );
+        std::fputs( "# sweater_calibrate profile\n", file );
+        std::fputs( "stealing_division_min = 2\n", file );
+        std::fputs( "stealing_division_max = 99\n", file ); // (clamped to the limit)
+        std::fputs( "unknown_key = 7\n", file );
+        std::fclose( file );
+    }
+    shop::options options;
+    EXPECT_TRUE( options.load_profile( profile_path ) );
+    EXPECT_EQ( options.stealing_division_min, 2 );
+    EXPECT_EQ( options.stealing_division_max, shop::options::stealing_division_limit );
+    EXPECT_FALSE( options.load_profile( "no/such/sweater.profile" ) );
+    std::remove( profile_path );
+
+    shop work_shop{ std::move( options ) };
+    iteration_sum sum;
+    work_shop.spread_the_sweat( 1000, sum.adder() );
+    EXPECT_EQ( sum.total(), iteration_sum::of( 1000 ) );
+}
+
+#if PSI_SWEATER_EXACT_WORKER_SELECTION
+TEST( SweaterSmoke, WakeTreesOfAnyArityCompleteSpreads )
+{
+    using shop = psi::sweater::shop;
+    for ( std::uint8_t const arity : { 1, 2, 3, 8 } )
+    {
+        shop::options tree_options;
+        tree_options.wake_tree_arity = arity;
+        shop work_shop{ std::move( tree_options ) };
+        // Fewer parts than workers as well as full width spreads (run roots
+        // and subtree ends other than the pool's).
+        for ( std::uint32_t iterations{ 1 }; iterations <= 2U * work_shop.number_of_workers() + 1; ++iterations )
+        {
+            iteration_sum sum;
+            work_shop.spread_the_sweat( iterations, sum.adder() );
+            EXPECT_EQ( sum.total(), iteration_sum::of( iterations ) ) << "arity " << unsigned{ arity };
+        }
+    }
+}
+#endif // PSI_SWEATER_EXACT_WORKER_SELECTION
+
+#if PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+TEST( SweaterSmoke, AdaptiveSpinCompletesAcrossIdleGaps )
+{
+    using shop = psi::sweater::shop;
+    shop::options adaptive_options;
+    adaptive_options.adaptive_spin = true;
+    shop work_shop{ std::move( adaptive_options ) };
+
+    // Alternate back-to-back and gapped spreads so that the workers' (and
+    // the caller's) histories flip between spinning and parking.
+    for ( auto round{ 0 }; round < 64; ++round )
+    {
+        iteration_sum sum;
+        work_shop.spread_the_sweat( 1000, sum.adder() );
+        EXPECT_EQ( sum.total(), iteration_sum::of( 1000 ) );
+        if ( ( round / 16 ) % 2 )
+            std::this_thread::sleep_for( std::chrono::microseconds( 500 ) );
+    }
+}
+
+// The prediction: spin while work arrived within the window in at least half
+// of the last 16 idle periods, and every 16th period regardless (to re-probe
+// from a parking streak).
+TEST( SweaterSmoke, IdleGapHistorySpinsOnMostlyShortGapsAndReprobes )
+{
+    psi::sweater::shop::idle_gap_history history;
+    auto const missed { [ & ] { history.record( 1, 0 ); } }; // (beyond an empty spin window)
+    auto const arrived{ [ & ] { history.record( 0, 0 ); } };
+
+    EXPECT_TRUE( history.spin() ); // period 0: optimistic start
+    for ( auto gap{ 0 }; gap < 8; ++gap )
+        missed();
+    EXPECT_TRUE( history.spin() ); // period 1: 8 of 16 arrived
+    missed();
+    for ( auto period{ 2 }; period < 16; ++period )
+        EXPECT_FALSE( history.spin() ) << "period " << period;
+    EXPECT_TRUE ( history.spin() ); // period 16: the re-probe
+    EXPECT_FALSE( history.spin() );
+    for ( auto gap{ 0 }; gap < 7; ++gap )
+        arrived();
+    EXPECT_FALSE( history.spin() ); // 7 of 16: the optimistic start aged out
+    arrived();
+    EXPECT_TRUE ( history.spin() ); // 8 of 16
+}
+#endif // PSI_SWEATER_SPIN_BEFORE_SUSPENSION
+#endif // PSI_SWEATER_HAS_SHOP_OPTIONS
+
+#if PSI_SWEATER_HMP
+// The capacity-weighted split: contiguous shares covering every iteration,
+// proportional to the used cores' weights, each starting at its cluster's
+// first worker thread (the caller thread standing in for one of the first
+// cluster's cores).
+TEST( SweaterSmoke, HmpPartitionSharesAddUpAndStartAtTheirClusters )
+{
+    using shop = psi::sweater::shop;
+    shop::hmp_clusters_info info{};
+    info.cores[ 0 ] = 2; info.power[ 0 ] = 2 * 1024; // big
+    info.cores[ 1 ] = 4; info.power[ 1 ] = 4 *  512; // medium
+    info.cores[ 2 ] = 2; info.power[ 2 ] = 2 *  256; // little
+    auto const clusters{ shop::make_hmp_config( info, 3 ) };
+    EXPECT_EQ( clusters.number_of_cores, 8 );
+    EXPECT_EQ( clusters.core_weight[ 0 ], 1024 );
+    EXPECT_EQ( clusters.core_weight[ 1 ],  512 );
+    EXPECT_EQ( clusters.core_weight[ 2 ],  256 );
+
+    shop::hmp_share shares[ shop::hmp_config::max_clusters ];
+    ASSERT_EQ( shop::hmp_partition( clusters, 5000, 8, shares ), 3 );
+    // weights 2 * 1024 : 4 * 512 : 2 * 256 = 4 : 4 : 1
+    EXPECT_EQ( shares[ 0 ].end, 2222U );
+    EXPECT_EQ( shares[ 1 ].end, 4444U );
+    EXPECT_EQ( shares[ 2 ].end, 5000U );
+    EXPECT_EQ( shares[ 0 ].first_worker, 0 );
+    EXPECT_EQ( shares[ 1 ].first_worker, 2 - PSI_SWEATER_USE_CALLER_THREAD );
+    EXPECT_EQ( shares[ 2 ].first_worker, 6 - PSI_SWEATER_USE_CALLER_THREAD );
+
+    for ( std::uint32_t const iterations : { 1U, 2U, 7U, 1000U, 1001U, 4294967295U } )
+    {
+        for ( psi::thrd_lite::hardware_concurrency_t parts{ 1 }; ( parts <= 8 ) && ( parts <= iterations ); ++parts ) // (spreads use no more parts than iterations)
+        {
+            auto const used{ shop::hmp_partition( clusters, iterations, parts, shares ) };
+            ASSERT_GE( used, 1 );
+            ASSERT_LE( used, 3 );
+            std::uint32_t                        iteration { 0 };
+            psi::thrd_lite::hardware_concurrency_t used_parts{ 0 };
+            for ( auto cluster{ 0 }; cluster < used; ++cluster )
+            {
+                auto const & share{ shares[ cluster ] };
+                EXPECT_EQ( share.begin, iteration ) << iterations << '/' << unsigned{ parts } << " cluster " << cluster;
+                EXPECT_GE( share.end  , share.begin );
+                EXPECT_LE( share.parts, clusters.cores[ cluster ] );
+                EXPECT_LE( share.parts, share.end - share.begin );
+                iteration   = share.end;
+                used_parts += share.parts;
+            }
+            EXPECT_EQ( iteration, iterations ) << iterations << '/' << unsigned{ parts };
+            EXPECT_LE( used_parts, parts );
+            EXPECT_GE( shares[ 0 ].parts, 1 ) << iterations << '/' << unsigned{ parts }; // (the caller's part)
+        }
+    }
+}
+#endif // PSI_SWEATER_HMP
+
+#if PSI_SWEATER_TOPOLOGY
+TEST( SweaterSmoke, OnePerCoreSpreadsOverPhysicalCores )
+{
+    using shop = psi::sweater::shop;
+    auto const topology{ psi::thrd_lite::cpu_topology() };
+    if ( std::none_of( topology.begin(), topology.end(), []( psi::thrd_lite::cpu_info const & cpu ) noexcept { return cpu.smt_index != 0; } ) )
+        GTEST_SKIP() << "no SMT on this host";
+
+    shop work_shop{ shop::smt_policy::one_per_core };
+    EXPECT_GE( work_shop.number_of_workers(), 1 );
+    EXPECT_LE( work_shop.number_of_workers(), shop{}.number_of_workers() );
+
+    iteration_sum sum;
+    work_shop.spread_the_sweat( 1000, sum.adder() );
+    EXPECT_EQ( sum.total(), iteration_sum::of( 1000 ) );
+
+#ifdef __linux__
+    // Every (active) worker held in its own fire item until all of them are
+    // in one, reporting the CPUs it is pinned to: exactly one each and no
+    // two on the same core.
+    auto const workers{ static_cast<unsigned>( work_shop.number_of_active_workers() - PSI_SWEATER_USE_CALLER_THREAD ) };
+    std::vector<cpu_set_t> masks( workers );
+    std::atomic<unsigned>  arrived  { 0     };
+    std::atomic<unsigned>  done     { 0     };
+    std::atomic<bool>      timed_out{ false };
+    auto const deadline{ std::chrono::steady_clock::now() + std::chrono::seconds( 10 ) };
+    for ( unsigned item{ 0 }; item < workers; ++item )
+    {
+        work_shop.fire_and_forget( [ &, item ]() noexcept
+        {
+            (void)sched_getaffinity( 0, sizeof( masks[ item ] ), &masks[ item ] );
+            arrived.fetch_add( 1, std::memory_order_acq_rel );
+            while ( arrived.load( std::memory_order_acquire ) < workers )
+            {
+                if ( std::chrono::steady_clock::now() > deadline )
+                {
+                    timed_out.store( true, std::memory_order_relaxed );
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            done.fetch_add( 1, std::memory_order_release );
+        } );
+    }
+    while ( ( done.load( std::memory_order_acquire ) < workers ) && ( std::chrono::steady_clock::now() < deadline + std::chrono::seconds( 1 ) ) )
+        std::this_thread::yield();
+    ASSERT_EQ( done.load(), workers );
+    ASSERT_FALSE( timed_out.load() ) << "the workers did not all get an item";
+
+    std::vector<psi::thrd_lite::cpu_id_t> cores;
+    for ( auto const & mask : masks )
+    {
+        ASSERT_EQ( CPU_COUNT( &mask ), 1 );
+        auto const cpu{ std::find_if( topology.begin(), topology.end(), [ & ]( psi::thrd_lite::cpu_info const & info ) noexcept { return CPU_ISSET( info.id, &mask ); } ) };
+        ASSERT_NE( cpu, topology.end() );
+        EXPECT_EQ( cpu->smt_index, 0 ) << "CPU " << cpu->id;
+        cores.push_back( cpu->core );
+    }
+    std::sort( cores.begin(), cores.end() );
+    EXPECT_EQ( std::adjacent_find( cores.begin(), cores.end() ), cores.end() ) << "two workers on SMT siblings of one core";
+#endif // __linux__
+}
+#endif // PSI_SWEATER_TOPOLOGY
+
+#if PSI_SWEATER_TRACK_CPU_LIMITS && defined( __linux__ )
+// Pinning the calling thread (e.g. by a library or the application itself
+// for its own reasons) is not a process-wide limit and must leave the pool
+// alone.
+TEST( SweaterSmoke, MainThreadPinningDoesNotShrinkThePool )
+{
+    psi::sweater::shop work_shop;
+    auto const active{ work_shop.number_of_active_workers() };
+    cpu_set_t all_cpus;
+    ASSERT_EQ( ::sched_getaffinity( 0, sizeof( all_cpus ), &all_cpus ), 0 );
+    if ( CPU_COUNT( &all_cpus ) < 2 )
+        GTEST_SKIP() << "needs at least two CPUs";
+
+    cpu_set_t one_cpu;
+    CPU_ZERO( &one_cpu );
+    for ( int cpu{ 0 }; cpu < CPU_SETSIZE; ++cpu )
+    {
+        if ( CPU_ISSET( cpu, &all_cpus ) )
+        {
+            CPU_SET( cpu, &one_cpu );
+            break;
+        }
+    }
+    ASSERT_EQ( ::sched_setaffinity( 0, sizeof( one_cpu ), &one_cpu ), 0 );
+    work_shop.refresh_cpu_limits();
+    EXPECT_EQ( work_shop.number_of_active_workers(), active );
+    ASSERT_EQ( ::sched_setaffinity( 0, sizeof( all_cpus ), &all_cpus ), 0 );
+
+    work_shop.limit_cpus( 1 );
+    EXPECT_EQ( work_shop.number_of_active_workers(), 1 );
+    work_shop.limit_cpus( 0 );
+    EXPECT_EQ( work_shop.number_of_active_workers(), active );
+}
+#endif // PSI_SWEATER_TRACK_CPU_LIMITS && Linux
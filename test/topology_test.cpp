@@ -0,0 +1,237 @@
+//==============================================================================
+// Tests for psi::thrd_lite's topology helpers (topology.hpp) that do not
+// depend on the host machine: the sysfs parsing and locality ordering of
+// read_numa_nodes()/read_cpu_topology() over synthesized sysfs trees (Linux
+// only - elsewhere there is no sysfs to discover from) and the NUMA node
+// layout of consecutive slots over a given CPU sequence (what the generic
+// shop's worker placement uses).
+//==============================================================================
+
+#include <psi/sweater/threading/topology.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+namespace psi::thrd_lite
+{
+//------------------------------------------------------------------------------
+
+namespace
+{
+    // A scratch /sys/devices/system lookalike, removed with the object.
+    class sysfs_tree
+    {
+    public:
+        sysfs_tree()
+            :
+            root_
+            {
+                std::filesystem::path{ ::testing::TempDir() } /
+                ( std::string{ "psi_topology_" } + ::testing::UnitTest::GetInstance()->current_test_info()->name() )
+            }
+        {
+            std::filesystem::remove_all( root_ );
+        }
+        ~sysfs_tree() { std::filesystem::remove_all( root_ ); }
+
+        void add( std::string const & relative_path, std::string const & content )
+        {
+            auto const path{ root_ / relative_path };
+            std::filesystem::create_directories( path.parent_path() );
+            std::ofstream{ path } << content << '\n';
+        }
+
+        // One CPU: its core/cluster/package sibling lists and its data/unified
+        // caches ({ level, shared_cpu_list }) preceded by an instruction L1
+        // (which has to be skipped).
+        void add_cpu( unsigned const cpu, std::string const & siblings, std::string const & cluster, std::string const & package, std::vector<std::pair<int, std::string>> const & caches )
+        {
+            auto const dir{ "cpu/cpu" + std::to_string( cpu ) };
+            add( dir + "/topology/thread_siblings_list", siblings );
+            add( dir + "/topology/cluster_cpus_list"   , cluster  );
+            add( dir + "/topology/package_cpus_list"   , package  );
+            add( dir + "/cache/index0/level"           , "1"           );
+            add( dir + "/cache/index0/type"            , "Instruction" );
+            add( dir + "/cache/index0/shared_cpu_list" , std::to_string( cpu ) );
+            for ( std::size_t index{ 0 }; index < caches.size(); ++index )
+            {
+                auto const cache_dir{ dir + "/cache/index" + std::to_string( index + 1 ) };
+                add( cache_dir + "/level"          , std::to_string( caches[ index ].first ) );
+                add( cache_dir + "/type"           , "Unified" );
+                add( cache_dir + "/shared_cpu_list", caches[ index ].second );
+            }
+        }
+
+        std::string dir() const { return root_.string(); }
+
+    private:
+        std::filesystem::path root_;
+    }; // class sysfs_tree
+
+    std::vector<cpu_info> cpus_on_nodes( std::vector<std::uint16_t> const & nodes )
+    {
+        std::vector<cpu_info> cpus;
+        for ( auto const node : nodes )
+        {
+            auto const id{ static_cast<cpu_id_t>( cpus.size() ) };
+            cpus.push_back( { .id = id, .core = id, .smt_index = 0, .cluster = id, .l2 = id, .l3 = id, .package = node, .numa_node = node, .capacity = 1024, .capacity_class = 0 } );
+        }
+        return cpus;
+    }
+
+    void expect_ranges( std::vector<slot_range> const & ranges, std::vector<slot_range> const & expected )
+    {
+        ASSERT_EQ( ranges.size(), expected.size() );
+        for ( std::size_t slot{ 0 }; slot < ranges.size(); ++slot )
+        {
+            EXPECT_EQ( ranges[ slot ].begin, expected[ slot ].begin ) << "slot " << slot;
+            EXPECT_EQ( ranges[ slot ].end  , expected[ slot ].end   ) << "slot " << slot;
+        }
+    }
+} // anonymous namespace
+
+#ifdef __linux__
+TEST( Topology, ReadsNodesSkippingCpulessOnes )
+{
+    sysfs_tree sysfs;
+    sysfs.add( "node/online"       , "0-2"   );
+    sysfs.add( "node/node0/cpulist", "0,2-3" );
+    sysfs.add( "node/node1/cpulist", "1"     );
+    sysfs.add( "node/node2/cpulist", ""      ); // memory only (e.g. CXL)
+    auto const nodes{ read_numa_nodes( sysfs.dir().c_str() ) };
+    ASSERT_EQ( nodes.size(), 2U );
+    EXPECT_EQ( nodes[ 0 ].id, 0 );
+    EXPECT_EQ( nodes[ 0 ].cpus, ( std::vector<cpu_id_t>{ 0, 2, 3 } ) );
+    EXPECT_EQ( nodes[ 1 ].id, 1 );
+    EXPECT_EQ( nodes[ 1 ].cpus, ( std::vector<cpu_id_t>{ 1 } ) );
+
+    EXPECT_TRUE( read_numa_nodes( ( sysfs.dir() + "/missing" ).c_str() ).empty() );
+    EXPECT_TRUE( read_cpu_topology( ( sysfs.dir() + "/missing" ).c_str() ).empty() );
+}
+
+// x86 style numbering - SMT siblings n and n + 4 - on two nodes: the
+// locality order groups nodes, then L3s, then cores with their siblings.
+TEST( Topology, LocalityOrderGroupsNodesCachesAndSiblings )
+{
+    sysfs_tree sysfs;
+    sysfs.add( "cpu/online"        , "0-7"         );
+    sysfs.add( "node/online"       , "0-1"         );
+    sysfs.add( "node/node0/cpulist", "0-1,4-5"     );
+    sysfs.add( "node/node1/cpulist", "2-3,6-7"     );
+    for ( unsigned cpu{ 0 }; cpu < 8; ++cpu )
+    {
+        auto const core   { cpu % 4 };
+        auto const node   { core / 2 };
+        auto const cores  { std::to_string( core ) + "," + std::to_string( core + 4 ) };
+        auto const package{ node ? std::string{ "2-3,6-7" } : std::string{ "0-1,4-5" } };
+        sysfs.add_cpu( cpu, cores, cores, package, { { 2, cores }, { 3, package } } );
+    }
+    auto const cpus{ read_cpu_topology( sysfs.dir().c_str() ) };
+    ASSERT_EQ( cpus.size(), 8U );
+    std::vector<cpu_id_t> order;
+    for ( auto const & cpu : cpus )
+        order.push_back( cpu.id );
+    EXPECT_EQ( order, ( std::vector<cpu_id_t>{ 0, 4, 1, 5, 2, 6, 3, 7 } ) );
+    for ( auto const & cpu : cpus )
+    {
+        EXPECT_EQ( cpu.core     , cpu.id % 4            ) << cpu.id;
+        EXPECT_EQ( cpu.smt_index, cpu.id / 4            ) << cpu.id;
+        EXPECT_EQ( cpu.l2       , cpu.id % 4            ) << cpu.id;
+        EXPECT_EQ( cpu.l3       , ( cpu.id % 4 ) / 2 * 2 ) << cpu.id;
+        EXPECT_EQ( cpu.package  , cpu.l3               ) << cpu.id;
+        EXPECT_EQ( cpu.numa_node, ( cpu.id % 4 ) / 2    ) << cpu.id;
+        EXPECT_EQ( cpu.capacity , 1024                 ) << cpu.id;
+    }
+}
+
+// A big.LITTLE SoC without an L3 (the cluster L2 is the LLC), little cores
+// numbered first: the big ones lead the order, and fall into class 0.
+TEST( Topology, LocalityOrderPutsBigCoresFirst )
+{
+    sysfs_tree sysfs;
+    sysfs.add( "cpu/online", "0-5" );
+    for ( unsigned cpu{ 0 }; cpu < 6; ++cpu )
+    {
+        auto const big    { cpu >= 4 };
+        auto const cluster{ big ? std::string{ "4-5" } : std::string{ "0-3" } };
+        sysfs.add_cpu( cpu, std::to_string( cpu ), cluster, "0-5", { { 2, cluster } } );
+        sysfs.add( "cpu/cpu" + std::to_string( cpu ) + "/cpu_capacity", big ? "1024" : "446" );
+    }
+    auto const cpus{ read_cpu_topology( sysfs.dir().c_str() ) };
+    ASSERT_EQ( cpus.size(), 6U );
+    std::vector<cpu_id_t> order;
+    for ( auto const & cpu : cpus )
+        order.push_back( cpu.id );
+    EXPECT_EQ( order, ( std::vector<cpu_id_t>{ 4, 5, 0, 1, 2, 3 } ) );
+    for ( auto const & cpu : cpus )
+    {
+        auto const big{ cpu.id >= 4 };
+        EXPECT_EQ( cpu.capacity      , big ? 1024 : 446 ) << cpu.id;
+        EXPECT_EQ( cpu.capacity_class, big ? 0    : 1   ) << cpu.id;
+        EXPECT_EQ( cpu.l3            , big ? 4    : 0   ) << cpu.id; // (the L2 folded in)
+        EXPECT_EQ( cpu.cluster       , cpu.l3           ) << cpu.id;
+        EXPECT_EQ( cpu.smt_index     , 0                ) << cpu.id;
+        EXPECT_EQ( cpu.numa_node     , 0                ) << cpu.id; // (no node information)
+    }
+}
+
+// Without cpu_capacity the cpufreq maximum frequency stands in, scaled to
+// the fastest CPU; CPUs within 1/8 of each other share a class.
+TEST( Topology, CapacitiesFallBackToMaximumFrequencies )
+{
+    sysfs_tree sysfs;
+    sysfs.add( "cpu/online", "0-3" );
+    char const * const frequencies[]{ "3000000", "1500000", "2800000", "3000000" };
+    for ( unsigned cpu{ 0 }; cpu < 4; ++cpu )
+    {
+        sysfs.add_cpu( cpu, std::to_string( cpu ), std::to_string( cpu ), "0-3", { { 2, std::to_string( cpu ) }, { 3, "0-3" } } );
+        sysfs.add( "cpu/cpu" + std::to_string( cpu ) + "/cpufreq/cpuinfo_max_freq", frequencies[ cpu ] );
+    }
+    auto const cpus{ read_cpu_topology( sysfs.dir().c_str() ) };
+    ASSERT_EQ( cpus.size(), 4U );
+    std::vector<cpu_id_t> order;
+    for ( auto const & cpu : cpus )
+        order.push_back( cpu.id );
+    EXPECT_EQ( order, ( std::vector<cpu_id_t>{ 0, 2, 3, 1 } ) );
+    EXPECT_EQ( cpus[ 0 ].capacity, 1024 );
+    EXPECT_EQ( cpus[ 1 ].capacity, 2800000UL * 1024 / 3000000 );
+    EXPECT_EQ( cpus[ 2 ].capacity, 1024 );
+    EXPECT_EQ( cpus[ 3 ].capacity, 512 );
+    EXPECT_EQ( cpus[ 0 ].capacity_class, 0 );
+    EXPECT_EQ( cpus[ 1 ].capacity_class, 0 );
+    EXPECT_EQ( cpus[ 2 ].capacity_class, 0 );
+    EXPECT_EQ( cpus[ 3 ].capacity_class, 1 );
+}
+#endif // __linux__
+
+TEST( Topology, NumaSlotRangesSplitSlotsByNode )
+{
+    auto const cpus{ cpus_on_nodes( { 0, 0, 0, 0, 1, 1, 1, 1 } ) };
+    // The first CPU is skipped (left to the caller thread): slots 0-2 land on
+    // node 0, 3-6 on node 1.
+    expect_ranges( numa_slot_ranges( cpus, 7, 1 ), { { 0, 3 }, { 0, 3 }, { 0, 3 }, { 3, 7 }, { 3, 7 }, { 3, 7 }, { 3, 7 } } );
+    expect_ranges( numa_slot_ranges( cpus, 8, 0 ), { { 0, 4 }, { 0, 4 }, { 0, 4 }, { 0, 4 }, { 4, 8 }, { 4, 8 }, { 4, 8 }, { 4, 8 } } );
+}
+
+TEST( Topology, NumaSlotRangesWrapAroundTheCpus )
+{
+    // More slots than CPUs: slot 2 wraps back to node 0 and starts a new run
+    // (with slot 3) rather than joining slot 0's.
+    auto const cpus{ cpus_on_nodes( { 0, 0, 1 } ) };
+    expect_ranges( numa_slot_ranges( cpus, 5, 1 ), { { 0, 1 }, { 1, 2 }, { 2, 4 }, { 2, 4 }, { 4, 5 } } );
+}
+
+TEST( Topology, NumaSlotRangesOfASingleNodeSpanAllSlots )
+{
+    expect_ranges( numa_slot_ranges( cpus_on_nodes( { 0, 0 } ), 3, 1 ), { { 0, 3 }, { 0, 3 }, { 0, 3 } } );
+    EXPECT_TRUE( numa_slot_ranges( {}, 3, 1 ).empty() );
+    EXPECT_TRUE( numa_slot_ranges( cpus_on_nodes( { 0 } ), 0, 0 ).empty() );
+}
+
+//------------------------------------------------------------------------------
+} // namespace psi::thrd_lite
+//------------------------------------------------------------------------------